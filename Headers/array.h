@@ -1,100 +1,64 @@
 /* Array-Generator by Isaac Jung
-Last updated 12/18/2022
+Last updated 10/17/2026
 
 |===========================================================================================================|
-|   This header contains classes for managing the array in an automated fashion. The Interaction and T      |
-| classes are used to represent fundamental covering/locating/detecting array concepts that guide scoring   |
-| decisions during array generation. They are used only by the Array class and should not be instantiated   |
-| by any source file other than the one associated with this header. The Array class is the interface with  |
-| which other source files should work. It contains a constructor that builds all the internal data         |
-| structures, thereby allowing the instantiator to immediately call other methods which carry out random    |
-| row generation based on this data. See check.cpp for an example.                                          |
+|   This header contains classes for managing the array in an automated fashion. The Interaction class and  |
+| the T sets (size-d sets of Interactions, identified by rank) are used to represent fundamental covering/  |
+| locating/detecting array concepts that guide scoring decisions during array generation. They are used     |
+| only by the Array class and should not be instantiated by any source file other than the one associated   |
+| with this header. The Array class is the interface with which other source files should work. It contains |
+| a constructor that builds all the internal data structures, thereby allowing the instantiator to          |
+| immediately call other methods which carry out random row generation based on this data. See generate.cpp |
+| for an example.                                                                                           |
 |===========================================================================================================|
 */
 
 #include "parser.h"
 #include "factor.h"
-#include <map>
+#include "pool.h"
+#include "cache.h"
+#include "heap.h"
+#include "kernel.h"
+#include "sink.h"
+#include "snapshot.h"
+#include "rng.h"
+#include <atomic>
 #include <mutex>
 #include <thread>
 
-class T;    // forward declaration because Interaction and T have circular references
-
-class Interaction
+// view of a contiguous run of Single pointers owned by the Array; only meant for range-based for loops
+class SingleSpan
 {
     public:
-        // used only in verbose mode, to have some id associated with the interaction
-        uint32_t id = 0;
-
-        // the actual list of (factor, value) tuples
-        std::vector<Single*> singles;
-
-        // this tracks the set of tests (represented as row numbers) in which this interaction occurs;
-        // this row coverage is vital to analyzing the array's properties
-        std::set<uint64_t> rows;
-
-        // easy lookup bool to cut down on redundant checks
-        bool is_covered = false;
-
-        // this tracks all the T sets in which this interaction occurs; using this, one can obtain all the
-        // relevant sets when a new row with this interaction is added
-        std::set<T*> sets;  
-
-        // this tracks the set differences between the set of rows in which this Interaction occurs and the
-        // sets of rows in which relevant T sets this Interaction is not part of occur; that is, this is
-        // a field to map detection issues to their delta values
-        std::map<T*, uint16_t> deltas;
+        Single **begin() const;
+        Single **end() const;
+        uint64_t size() const;
+        Single *operator[](uint64_t idx) const;
+        SingleSpan(Single **first, uint64_t count);
 
-        // easy lookup bool to cut down on redundant checks
-        bool is_detectable = false;
-
-        // memoized to_string_internal
-        const std::string str_rep;
-
-        std::string to_string() const;      // returns a string representing all Singles in the interaction
-        Interaction(std::vector<Single*> *temp);    // constructor with a premade vector of Single pointers
-    
     private:
-        std::string to_string_internal(std::vector<Single*> *temp) const;
+        Single **first;
+        uint64_t count;
 };
 
-// I wasn't sure what to name this, except after the formal parameter used in Dr. Colbourn's definitions
-// Note that Colbourn's definitions use a script T: 𝒯 
-// This class is used to more easily compare the row coverage of different size-d sets of t-way interactions
-class T
+class Interaction
 {
     public:
-        // used only in verbose mode, to have some id associated with the T set
+        // used only in verbose mode, to have some id associated with the interaction
         uint32_t id = 0;
 
-        // for easier access to the singles themselves
-        std::vector<Single*> singles;
-
-        // for easier access to the interactions themselves
-        std::vector<Interaction*> interactions;
-
-        // each interaction in a given T set has its own version of this; the ρ associated with a T is simply
-        // the union of the ρ's for each interaction in that T
-        std::set<uint64_t> rows;
+        // index of this interaction in the Array's interactions vector; see build_t_way_interactions()
+        uint64_t rank = 0;
 
-        // this tracks all the T sets which occur in the same set of rows as this instance; when adding a
-        // row to the array, each T set occurring in the row must be compared to every other T set to see
-        // if their sets of rows are disjoint yet; if so, there is no longer a conflict; when the size of
-        // "location_conflicts" becomes 0 while the above set, "rows", is greater than 0, this T becomes
-        // locatable within the array
-        std::set<T*> location_conflicts;
+        // the actual list of (factor, value) tuples, stored in the Array's interaction_singles
+        SingleSpan singles;
 
-        // easy lookup bool to cut down on redundant checks
-        bool is_locatable = false;
-
-        // memoized to_string_internal
-        const std::string str_rep;
-
-        std::string to_string() const;      // returns a string representing all Interactions in the set
-        T(std::vector<Interaction*> *temp); // constructor with a premade vector of Interaction pointers
+        // this tracks the set of tests (represented as row numbers) in which this interaction occurs;
+        // this row coverage is vital to analyzing the array's properties
+        RowSet rows;
 
-    private:
-        std::string to_string_internal(std::vector<Interaction*> *temp) const;
+        std::string to_string() const;     // returns a string representing all Singles in the interaction
+        Interaction(uint64_t r, Single **first, uint16_t t);    // constructor with a premade run of Singles
 };
 
 class Array
@@ -124,33 +88,31 @@ class Array
         // used to catch failure states due to memory limitations
         bool out_of_memory = false;
 
-        // list of all individual Single (factor, value) pairs
+        // what rng was seeded with; the same seed and arguments always generate the same array (see --seed)
+        uint64_t seed;
+
+        // list of all individual Single (factor, value) pairs, in order of id
         std::vector<Single*> singles;
 
         // list of all individual t-way interactions
         std::vector<Interaction*> interactions;
 
-        // list of all size-d sets of t-way interactions
-        std::vector<T*> sets;
-
-        // really only needed by heuristic_all()
-        std::map<std::string, Single*> single_map;
-
-        // used by build_row_interactions()
-        std::map<std::string, Interaction*> interaction_map;
-
-        // really only needed by heuristic_all()
-        std::map<std::string, T*> t_set_map;
+        // number of size-d sets of t-way interactions (named T after the formal parameter, a script 𝒯, used
+        // in Dr. Colbourn's definitions); these are never materialized as objects: each T set is identified
+        // by its colexicographic rank among all d-subsets of interactions, and its Interactions and Singles
+        // are recovered from that rank on demand (see unrank_set())
+        uint64_t num_sets = 0;
 
         void print_stats(bool initial = false); // prints current stats such as score
         void add_row();                         // adds a row to the array based on scoring
         void add_row(uint16_t *row);            // adds a row to the array given as a parameter
-        std::string to_string();                // returns a string representing all rows
+        void add_rows(uint16_t *new_rows, uint64_t count);  // adds many given rows at once
+        void write_rows(RowSink *row_sink);     // writes all rows so far to a sink
+        void stream_rows(RowSink *row_sink);    // same, then keeps writing each row added to it
+        bool save_checkpoint(const std::string &filename);  // writes all state needed to pick up from here
+        bool load_checkpoint(const std::string &filename);  // picks up from a checkpoint, before any rows
         Array();                                // default constructor, don't use this
         Array(Parser *in);                      // constructor with an initialized Parser object
-        Array(uint64_t total_problems, uint64_t coverage_problems, uint64_t location_problems,
-            uint64_t detection_problems, std::vector<uint16_t*> *rows, uint64_t num_tests,
-            uint16_t num_factors, Factor **factors, prop_mode p, uint16_t d, uint16_t t, uint16_t delta);
         ~Array();                   // deconstructor
 
     private:
@@ -166,8 +128,11 @@ class Array
         // subset of total_issues representing just detection
         uint64_t detection_problems;
         
-        // list of the rows themselves, as a vector of int arrays
-        std::vector<uint16_t*> rows;
+        // the rows themselves, stored contiguously; row r (0-indexed) starts at rows[r*num_factors]
+        std::vector<uint16_t> rows;
+
+        // where each row is written as soon as it is added, if anywhere; see stream_rows()
+        RowSink *sink = nullptr;
 
         // field to track the current number of rows
         uint64_t num_tests;
@@ -181,18 +146,127 @@ class Array
         // for tracking which factors have solved all issues of which categories
         prop_mode *dont_cares;
 
-        // memoized heuristic_all scores
-        std::map<std::string, uint64_t> row_scores;
+        // every Single and Interaction is allocated in one of these arenas, sized once in the constructor so
+        // that pointers into them stay valid; nothing in them is ever freed individually
+        std::vector<Single> single_arena;
+        std::vector<Interaction> interaction_arena;
+
+        // the Singles of every Interaction, t at a time; Interaction r's are at [r*t, (r + 1)*t)
+        std::vector<Single*> interaction_singles;
 
-        // used to help avoid redundant checks in heuristic_all
-        uint64_t min_positive_score = UINT64_MAX;
+        // in how many Interactions each Single (indexed by id) appears; never changes once built
+        std::vector<uint64_t> interaction_counts;
 
-        // used to help avoid redundant checks for heuristics that do something only on the first call
-        bool just_switched_heuristics = false;
+        // in how many coverage, location, and detection issues each Single (indexed by id) appears
+        std::vector<uint64_t> c_issues;
+        std::vector<uint64_t> l_issues;
+        std::vector<uint64_t> d_issues;
+
+        // binomial coefficients C(n, k) for 0 <= k <= t and 0 <= n <= num_factors, stored as
+        // tuple_binomials[k*(num_factors + 1) + n]; saturates at UINT64_MAX instead of overflowing
+        std::vector<uint64_t> tuple_binomials;
+
+        // Interactions (by rank) keyed by how much attention they need, for choosing one to lock in a row (see
+        // worst_key()); built the first time it is needed, then kept up to date by update_scores(), unless so
+        // many keys change at once that it is cheaper to build it again the next time it is needed
+        IndexedHeap worst_heap;
+        bool worst_heap_valid = false;
+
+        // easy lookup flags to cut down on redundant checks, indexed by interaction rank
+        std::vector<uint8_t> is_covered;
+        std::vector<uint8_t> is_detectable;
+
+        // t copies of the negation of is_covered, one per position within a column tuple; in copy j (starting
+        // at j*interactions.size()), each tuple's Interactions are reordered so that the value of the tuple's
+        // j-th column is the least significant digit, which puts the flags for every value of that column side
+        // by side; followed by CoverageKernel::PADDING bytes, see column_gains()
+        std::vector<uint8_t> uncovered_views;
+        CoverageKernel coverage_kernel;
+
+        // binomial coefficients C(n, k) for 0 <= k <= d and 0 <= n <= interactions.size(), stored as
+        // set_binomials[k*(interactions.size() + 1) + n]; saturates at UINT64_MAX instead of overflowing
+        std::vector<uint64_t> set_binomials;
+
+        // location is tracked as a partition of the T sets into classes of sets occurring in exactly the
+        // same rows; two T sets have a location conflict exactly when they share a class, so a T set becomes
+        // locatable once its class is a singleton; each added row splits the classes of the T sets in it
+        // into the part in the row and the part not in it; class 0 is reserved for the T sets that have not
+        // occurred in any row yet, which are considered to conflict with every other T set
+
+        // ranks of all T sets, ordered such that each class occupies a contiguous range
+        std::vector<uint64_t> set_order;
+
+        // position of each T set (indexed by rank) in set_order
+        std::vector<uint64_t> set_position;
+
+        // class of each T set, indexed by rank
+        std::vector<uint64_t> set_class;
+
+        // where each class's range in set_order begins, and how many T sets are in it
+        std::vector<uint64_t> class_start;
+        std::vector<uint64_t> class_size;
+
+        // scratch space for update_scores(): how many T sets of each class occur in the new row
+        std::vector<uint64_t> class_split;
+
+        // scratch space for heuristic_l_only() and heuristic_l_and_d(): per Single (indexed by id), how much
+        // it is involved in what those heuristics are trying to solve
+        std::vector<uint64_t> single_scores;
+
+        // per Interaction (indexed by rank), how many of the T sets containing it are still in class 0
+        std::vector<uint64_t> unseen_sets;
+
+        // this tracks the size of the set difference between the set of rows in which each Interaction
+        // occurs and the set of rows in which each T set occurs, saturating at delta since nothing beyond
+        // that matters; indexed [interaction rank*num_sets + T rank]; entries for T sets that contain the
+        // Interaction start out at delta, since those are not detection issues
+        std::vector<uint8_t> separations;
+
+        // per Interaction, one bit for each block of 64 T ranks in which some separation is still below
+        // delta, so that finished blocks drop out of iteration; indexed [interaction rank*active_words + word]
+        std::vector<uint64_t> active_blocks;
+        uint64_t active_words = 0;
+
+        // per Interaction, how many bits are set in its active_blocks; it is detectable once this reaches 0
+        std::vector<uint64_t> active_block_count;
+
+        // scratch space for update_scores(): one bit for each T set in the new row, indexed by rank
+        std::vector<uint64_t> row_set_bits;
+
+        // per Single (indexed by id), the most that heuristic_all could score for any row containing it;
+        // refreshed at the start of every heuristic_all call, see build_score_bounds()
+        std::vector<uint64_t> single_bounds;
+
+        // per Single (indexed by id), the value of the Single that heuristic_all should try in that position;
+        // each factor's values are in decreasing order of their single_bounds
+        std::vector<uint16_t> value_order;
+
+        // indexed by column position in permutation, the most that the columns from there on could add
+        std::vector<uint64_t> remaining_bounds;
+
+        // best score heuristic_all has seen so far; candidates whose bound is lower need not be scored
+        std::atomic<uint64_t> best_row_score;
+
+        // keys of the rows tied for best_row_score so far during a heuristic_all call; guarded by scores_mutex
+        std::vector<uint64_t> best_rows;
+        std::vector<uint16_t> best_row_values;  // the same rows' values instead, when rows have no keys
+
+        // indexed by column, the place value of that column's value in a row's key, with column 0 the most
+        // significant digit; empty if there are too many possible rows for their keys to fit in 64 bits, in
+        // which case heuristic_all goes without score_cache and keeps the values of its best rows instead
+        std::vector<uint64_t> row_radix;
+
+        // heuristic_all scores carried over from one call to the next, keyed as above; a score holds until
+        // a new row changes something it depends on, at which point invalidate_cached_scores() marks it stale
+        ScoreCache *score_cache;
+        uint64_t score_cache_bytes; // memory cap for the above, which is made the first time it is needed
 
         // for dictating order of iteration; should be regularly shuffled
         uint16_t *permutation;
 
+        // source of every random choice; only drawn from by the main thread, since the workers never need it
+        Rng rng;
+
         // this makes the program print out data structures and program flow when enabled
         debug_mode debug;
 
@@ -211,53 +285,111 @@ class Array
         // needed by heuristic_all_scorer() to update scores in threads safely
         std::mutex scores_mutex;
 
-        // needed by clone() to ensure threads don't get bottlenecked by memory limitations
-        std::mutex memory_mutex;
+        // upper bound on number of threads allowed; lowered by plan_memory() to fit a memory budget
+        uint32_t max_threads = std::thread::hardware_concurrency();
 
-        // upper bound on number of threads allowed
-        const uint32_t max_threads = std::thread::hardware_concurrency();
+        // workers for building the data structures in parallel and scoring candidate rows for heuristic_all();
+        // started by the constructor, or the first time they are needed if they could not be started then
+        ThreadPool *pool;
+
+        // index into interactions at which each column tuple's interactions begin, with tuples in
+        // lexicographic order; an interaction's rank is its tuple's offset plus its mixed-radix value index
+        std::vector<uint64_t> tuple_offsets;
 
         // this utility method is called in the constructor to fill out the vector of all interactions
         // almost certainly needs to be recursive in order to handle arbitrary values of t
-        void build_t_way_interactions(uint16_t start, uint16_t t_cur, std::vector<Single*> *singles_so_far);
-
-        // after the above method completes, call this one to fill out the set of all size-d sets
-        // almost certainly needs to be recursive in order to handle arbitrary values of d
-        void build_size_d_sets(uint16_t start, uint16_t d_cur, std::vector<Interaction*> *interactions_so_far);
+        void build_t_way_interactions(uint16_t start, uint16_t t_cur, std::vector<uint16_t> *cols_so_far,
+            std::vector<uint16_t> *tuple_cols);
+        void fill_interactions(std::vector<uint16_t> *tuple_cols);  // gives them Singles, in parallel
+
+        // this one is called first of all, to turn away problems too big for the memory budget, if any
+        bool plan_memory(std::vector<uint16_t> *levels, uint64_t budget);
+
+        // these utility methods are called in the constructors before the above, to lay out the arenas
+        void build_singles(std::vector<uint16_t> *levels);
+        void reserve_interactions();
+
+        // after the above method completes, call this one to count the size-d sets and prepare for ranking them
+        void build_size_d_sets();
+
+        // for detection only, call this one last to fill out the table of separations, in parallel
+        void build_separations();
+
+        // helpers for going between T sets and their ranks; see array.cpp for the ordering used
+        uint64_t choose(uint64_t n, uint16_t k) const;
+        uint64_t rank_set(uint64_t *members) const;
+        void unrank_set(uint64_t rank, uint64_t *members) const;
+        void sets_containing(uint64_t member, std::vector<uint64_t> *ranks) const;
+        uint64_t tuple_rank(uint16_t *cols) const;
+        void interactions_containing(Single *s, std::vector<uint64_t> *ranks) const;
+        std::string set_to_string(uint64_t rank) const;
+        uint64_t location_conflicts(uint64_t rank) const;
+        void location_totals(std::vector<uint64_t> *totals) const;
+        uint16_t separation(Interaction *i, uint64_t rank) const;
+        void unseparated_sets(Interaction *i, std::vector<uint64_t> *ranks) const;
 
         // this utility method closely mimics the build_t_way_interactions() method, but uses the information
-        // from a given row to fill out a set of interactions representing those that appear in the row
-        void build_row_interactions(uint16_t *row, std::set<Interaction*> *row_interactions,
-            uint16_t start, uint16_t t_cur, std::string key);
+        // from a given row to fill out a vector of interactions representing those that appear in the row
+        void build_row_interactions(uint16_t *row, std::vector<Interaction*> *row_interactions);
+        void build_row_interactions(uint16_t *row, std::vector<Interaction*> *row_interactions,
+            uint16_t start, uint16_t t_cur, uint64_t value_idx, uint64_t *tuple_idx);
+
+        // likewise, but only for the interactions of the row that go through the given column
+        void build_column_interactions(uint16_t *row, uint16_t col,
+            std::vector<Interaction*> *col_interactions);
+
+        // counts of the uncovered Interactions that each value of a column would complete in a partial row
+        void column_gains(uint16_t *row, uint16_t col, bool *placed, uint32_t *gains);
+        void mark_covered(Interaction *i);  // clears an Interaction's flags in uncovered_views
 
         uint16_t *initialize_row_R();                                           // randomly generated row
         uint16_t *initialize_row_R(Interaction **locked, std::vector<Interaction*> *ties = nullptr);
+        uint64_t worst_key(Interaction *i) const;
         uint16_t *initialize_row_S();                                           // based on Singles
-        uint16_t *initialize_row_T(T **l_set, Interaction **l_interaction);     // based on T sets
+        uint16_t *initialize_row_T(uint64_t *l_set, Interaction **l_interaction);   // based on T sets
         uint16_t *initialize_row_I(Interaction **locked);                       // based on Interactions
 
         void heuristic_c_only(uint16_t *row);
-        int32_t heuristic_c_helper(uint16_t *row, std::set<Interaction*> *row_interactions, int32_t *problems);
+        int32_t heuristic_c_helper(uint16_t *row, std::vector<Interaction*> *row_interactions,
+            int32_t *problems);
+        void add_c_problems(std::vector<Interaction*> *row_interactions, int32_t *problems, int32_t sign);
+        void change_column(uint16_t *row, uint16_t col, uint16_t val, uint64_t *missing,
+            uint64_t *total_missing);
         
-        void heuristic_l_only(uint16_t *row, T *l_set, Interaction *l_interaction);
+        void heuristic_l_only(uint16_t *row, uint64_t l_set, Interaction *l_interaction);
 
         void heuristic_l_and_d(uint16_t *row, Interaction *locked);
+        void choose_least_scored(uint16_t *row, bool *locked_factors);
 
         bool heuristic_all(uint16_t *row);
         bool heuristic_all(uint16_t *row, Interaction *locked);
-        void heuristic_all_helper(uint16_t *row, uint16_t cur_col, std::vector<std::thread*> *threads,
-            Interaction *locked = nullptr, std::map<std::string, uint64_t> *local_scores = nullptr);
-        void heuristic_all_scorer(uint16_t *row, std::string row_str,
-            std::map<std::string, uint64_t> *local_scores = nullptr);
+        void heuristic_all_helper(uint16_t *row, uint16_t cur_col, uint64_t bound, uint64_t key,
+            Interaction *locked);
+        void heuristic_all_scorer(uint16_t *row, uint64_t key);
+        void record_row_score(uint64_t key, uint64_t row_score, const uint16_t *row);
+        void build_score_bounds(uint16_t *row, Interaction *locked);
+        uint64_t score_row(uint16_t *row);
         
-        void update_array(uint16_t *row, bool keep = true);
-        void update_scores(std::set<Interaction*> *row_interactions, std::set<T*> *row_sets);
+        void update_array(uint16_t *row);
+        void load_coverage(std::vector<uint64_t> *row_relief);
+        void load_detection(std::vector<uint64_t> *occurs, uint64_t words, std::vector<uint64_t> *row_relief);
+        void update_scores(std::vector<Interaction*> *row_interactions, std::vector<uint64_t> *row_sets);
+        void invalidate_cached_scores(std::vector<Interaction*> *row_interactions,
+            std::vector<uint64_t> *row_sets);
+        void update_interactions(std::vector<Interaction*> *row_interactions, uint64_t begin, uint64_t end,
+            uint64_t *c_relief, uint64_t *d_relief, uint64_t *solved);
+        void split_classes(std::vector<uint64_t> *row_sets, std::vector<std::pair<uint64_t, uint64_t>> *relief);
+        void relieve_location_issues(uint64_t rank, uint64_t amount, uint64_t *relief) const;
+        void update_worst_heap(std::vector<Interaction*> *row_interactions, std::vector<uint8_t> *changed);
+        void solve_location_problem();
         void update_dont_cares();
         void update_heuristic();
 
-        Array *clone(); // for getting a copy of this, including deep copying of object references
-
         void report_out_of_memory();    // sets out_of_memory to true with a message
 
-        bool probe_memory_for_threads();    // checks if there is enough memory for heuristic_all()
+        bool start_pool();  // starts the workers if they are not running yet
+        uint64_t chunk_count(uint64_t n, uint64_t grain = 1) const;
+        void run_chunks(uint64_t n, uint64_t chunks,
+            const std::function<void(uint64_t begin, uint64_t end, uint64_t chunk)> &task);
+        bool start_heuristic_all();     // makes the workers and score cache for heuristic_all() if not made yet
 };
\ No newline at end of file
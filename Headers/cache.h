@@ -0,0 +1,63 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This header contains a class used for remembering the scores of candidate rows from one row to the     |
+| next. Candidate rows are identified by packed integer keys (see Array::row_radix), and their scores are   |
+| kept in an open-addressing hash table whose size is fixed up front from a memory cap, so the cache never  |
+| grows past what it was allowed. When a new key has no room near its home position, the least useful      |
+| entry nearby is evicted: an empty one first, then one whose score has gone stale, then the one that went  |
+| the longest without being used. Each entry also depends on a handful of tags (for the Array, the ranks of |
+| the Interactions in the row), and an inverted index from each tag to the entries depending on it lets a   |
+| caller mark exactly the affected entries stale when something about a tag changes.                       |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef CACHE
+#define CACHE
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class ScoreCache
+{
+    public:
+        bool lookup(uint64_t key, uint64_t *score);                 // gets a score if it is cached and fresh
+        void store(uint64_t key, uint64_t score, const std::vector<uint64_t> &tags);    // caches a score
+        void invalidate(uint64_t tag);      // marks stale every entry depending on the tag
+        void invalidate_all();              // marks stale every entry
+        void tick();                        // starts a new round of lookups, for deciding what to evict
+        bool empty() const;                 // whether nothing has been stored yet
+        uint64_t capacity() const;          // number of entries the table can hold
+
+        ScoreCache(uint64_t max_bytes, uint64_t num_tags, uint64_t tags_per_key_o);
+
+    private:
+        static const uint64_t NO_KEY = UINT64_MAX;  // marks an entry that has never been used
+        static const uint64_t PROBES = 8;           // how far from its home position a key may be stored
+
+        std::mutex lock;            // guards everything below
+        uint64_t mask;              // capacity - 1, where capacity is a power of 2
+        uint64_t tags_per_key;      // how many tags each stored key depends on
+        uint32_t clock = 0;         // current round, see tick()
+        bool used = false;          // whether store() has been called yet
+
+        // per entry, in parallel
+        std::vector<uint64_t> keys;         // key of the row held, or NO_KEY
+        std::vector<uint64_t> scores;       // score the row last had
+        std::vector<uint8_t> fresh;         // whether that score still holds
+        std::vector<uint32_t> generation;   // bumped every time the entry is given to a new key
+        std::vector<uint32_t> last_used;    // round in which the entry was last looked up or stored
+
+        // per tag, (entry, generation) of every entry stored while depending on it; pairs whose generation
+        // no longer matches the entry's are stale, and are dropped lazily
+        std::vector<std::vector<std::pair<uint32_t, uint32_t>>> dependents;
+        uint64_t dependent_count = 0;   // pairs in all of dependents, stale or not
+
+        uint64_t home(uint64_t key) const;      // position at which a key's probing starts
+        void compact_dependents();              // drops every stale pair from dependents
+};
+
+#endif // CACHE
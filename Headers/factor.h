@@ -1,5 +1,5 @@
 /* Array-Generator by Isaac Jung
-Last updated 11/14/2022
+Last updated 10/17/2026
 
 |===========================================================================================================|
 |   This header contains classes used for organizing data associated with the Array class. There should be  |
@@ -14,7 +14,9 @@ Last updated 11/14/2022
 | array of pointers to the Singles whose factor matches. I.e., the nth column will have access to a list of |
 | all Singles of the form (n, v_i), where v_i is some value in valid range of the nth column's levels.      |
 | Please note that this module does not handle the building of data structures such that this property is   |
-| maintained; the Array module must guarantee it as it instantiates Single and Factor objects.              |
+| maintained; the Array module must guarantee it as it instantiates Single and Factor objects. The Singles  |
+| themselves live in one contiguous arena owned by the Array, which also keeps the per-Single issue counts  |
+| in parallel arrays indexed by each Single's id, so that scans over those counts stay compact and fast.    |
 |===========================================================================================================|
 */
 
@@ -23,20 +25,15 @@ Last updated 11/14/2022
 #define FACTOR
 
 #include "parser.h"
+#include "rowset.h"
 #include <set>
 
 // basically just a tuple, but with a set of rows in which it occurs
 class Single
 {
     public:
-        // in how many coverage issues does this Single appear
-        uint64_t c_issues = 0;
-
-        // in how many location issues does this Single appear
-        uint64_t l_issues = 0;
-
-        // in how many detection issues does this Single appear
-        uint64_t d_issues = 0;
+        // index of this Single in the Array's arena; Singles are laid out by factor, then by value
+        const uint32_t id;
 
         // represents the factor, or column of the array
         const uint16_t factor;
@@ -45,13 +42,13 @@ class Single
         const uint16_t value;
 
         // tracks the set of rows in which this (factor, value) occurs
-        std::set<uint64_t> rows;
+        RowSet rows;
 
         // memoized to_string_internal
         const std::string str_rep;
 
         std::string to_string() const;  // returns a string representing the (factor, value)
-        Single(uint64_t f, uint64_t v); // constructor that takes the (factor, value)
+        Single(uint64_t f, uint64_t v, uint32_t i); // constructor that takes the (factor, value) and id
 
     private:
         std::string to_string_internal() const;
@@ -76,11 +73,11 @@ class Factor
         // number of values the column can take on
         const uint16_t level = 0;
 
-        // pointer to array of Single pointers
-        Single **singles = nullptr;
+        // pointer to this factor's first Single in the Array's arena, followed by the rest in order of value;
+        // the Factor does not own them
+        Single *singles = nullptr;
 
-        Factor(uint16_t i, uint16_t l, Single **ptr_array); // constructor that takes id, level, Single*
-        ~Factor();                                          // deconstructor
+        Factor(uint16_t i, uint16_t l, Single *first);  // constructor that takes id, level, first Single
 };
 
 #endif // FACTOR
@@ -0,0 +1,40 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This header contains a class used for keeping track of which of many items has the largest key, when    |
+| only a few of the keys change at a time. It is a binary max-heap over the ids [0, n), along with the      |
+| position of every id in the heap, so that the key of any id can be changed in place in logarithmic time   |
+| rather than by searching for it. The heap is built all at once in linear time from a full list of keys.   |
+| Since callers need to break ties themselves, every id tied for the largest key can be gathered as well,   |
+| in time proportional to the number of ties rather than the number of ids.                                 |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef HEAP
+#define HEAP
+
+#include <cstdint>
+#include <vector>
+
+class IndexedHeap
+{
+    public:
+        void build(const std::vector<uint64_t> &keys_o);    // replaces the ids and keys, all at once
+        void update(uint64_t id, uint64_t key);             // changes the key of one id
+        uint64_t top_key() const;                           // largest key; the heap must not be empty
+        void top_ties(std::vector<uint64_t> *ids) const;    // every id with the largest key, in order
+        bool empty() const;                                 // whether there are no ids
+
+    private:
+        std::vector<uint64_t> keys;     // per id, its current key
+        std::vector<uint64_t> heap;     // ids in heap order; an id's key is never less than its children's
+        std::vector<uint64_t> position; // per id, its index in heap
+
+        void sift_up(uint64_t pos);     // moves an id towards the root until it is in heap order
+        void sift_down(uint64_t pos);   // moves an id towards the leaves until it is in heap order
+        void place(uint64_t pos, uint64_t id);  // puts an id at a position, keeping position up to date
+};
+
+#endif // HEAP
@@ -0,0 +1,39 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This header contains a class used for adding up many short runs of 0/1 flags position by position, the  |
+| inner loop of counting how many uncovered Interactions each value of a column would cover. Each run sits  |
+| somewhere in one large table of flags, and every run is the same width (the number of values), so the sum |
+| for each position is a count over all the runs. Which implementation does the adding is chosen once, when |
+| the object is made, from what the processor running the program supports: AVX2 or SSE2 where available,  |
+| or a plain loop otherwise. The vector versions read whole registers at a time, so the table must have     |
+| PADDING bytes after its last run that are safe to read; whatever is in them never reaches the sums.       |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef KERNEL
+#define KERNEL
+
+#include <cstdint>
+
+class CoverageKernel
+{
+    public:
+        static const uint64_t PADDING = 32;     // bytes past the end of the last run that may be read
+
+        // adds each run's flags into sums, where every flag is 0 or 1 and run r starts at flags[starts[r]]
+        void sum_runs(const uint8_t *flags, const uint64_t *starts, uint64_t runs, uint16_t width,
+            uint32_t *sums) const;
+        const char *name() const;   // which implementation was chosen
+
+        CoverageKernel();
+
+    private:
+        void (*sum)(const uint8_t *flags, const uint64_t *starts, uint64_t runs, uint16_t width,
+            uint32_t *sums);
+        const char *sum_name;
+};
+
+#endif // KERNEL
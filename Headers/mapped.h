@@ -0,0 +1,37 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This header contains a class used for reading a whole file as one block of memory. The file is mapped   |
+| into memory rather than read, so that even a very large file costs no copying and no allocation; the      |
+| pages are brought in by the system as they are touched, and a sequential pass is hinted to it. Anything   |
+| that cannot be mapped, such as a pipe, or an empty file, is read into a buffer instead, so the caller     |
+| sees the same thing either way: a pointer to the bytes and how many there are.                            |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef MAPPED
+#define MAPPED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class MappedFile
+{
+    public:
+        bool open(const std::string &filename); // maps the file, or reads it if it cannot be mapped
+        const char *data() const;               // the bytes of the file, valid until close()
+        uint64_t size() const;                  // how many bytes there are
+        void close();                           // unmaps the file, or frees what was read
+
+        ~MappedFile();
+
+    private:
+        void *mapping = nullptr;    // the mapped file, or nullptr if it was read into buffer instead
+        uint64_t length = 0;        // bytes in mapping or buffer
+        std::vector<char> buffer;   // the file's bytes, when it could not be mapped
+};
+
+#endif // MAPPED
@@ -0,0 +1,47 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This header contains what is shared between writing and reading the packed binary format for arrays     |
+| (see --binary in README.md). A packed file starts with a header, all of it little-endian no matter the    |
+| machine: the 8 bytes of PACKED_MAGIC, the number of factors and each factor's level (16 bits apiece), the |
+| d, t, and δ the array was generated for (16 bits apiece, 0 for any that were not asked for), the number   |
+| of rows, and the seed of the run (64 bits apiece). The rows follow right after, one after another with no |
+| padding between them, each value taking only as many bits as its factor's level needs, lowest bit first;  |
+| the last byte is padded with zeros. The number of rows is only filled in once the file is finished; until |
+| then it is PACKED_UNKNOWN_ROWS, and a reader should count the whole rows that fit in what follows.        |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef PACKED
+#define PACKED
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// marks the start of a packed file, and which layout it has
+const char PACKED_MAGIC[8] = {'A', 'G', 'A', 'R', 'R', 'A', 'Y', '1'};
+
+// number of rows in the header of a packed file that was never finished
+const uint64_t PACKED_UNKNOWN_ROWS = UINT64_MAX;
+
+// what the header of a packed file holds
+struct PackedHeader
+{
+    std::vector<uint16_t> levels;   // level of each factor
+    uint16_t d = 0;                 // size of T sets, or 0 if location was not asked for
+    uint16_t t = 0;                 // strength of interactions
+    uint16_t delta = 0;             // separation, or 0 if detection was not asked for
+    uint64_t rows = PACKED_UNKNOWN_ROWS;
+    uint64_t seed = 0;              // seed of the run that generated the array
+};
+
+uint8_t packed_width(uint16_t level);   // bits a value of a factor with this level takes
+uint64_t packed_rows_offset(uint16_t num_factors);  // where in the header the number of rows is
+void pack_header(const PackedHeader &header, std::string *bytes);
+bool is_packed(const char *data, uint64_t size);
+bool unpack_header(const char *data, uint64_t size, PackedHeader *header, uint64_t *length);
+
+#endif // PACKED
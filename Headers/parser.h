@@ -1,5 +1,5 @@
 /* Array-Generator by Isaac Jung
-Last updated 12/22/2022
+Last updated 10/17/2026
 
 |===========================================================================================================|
 |   This header contains a class used for processing input. Should the input format change, this class can  |
@@ -72,9 +72,6 @@ class Parser
     public:
         // output filename
         std::string out_filename;
-
-        // output file
-        std::ofstream out;
         
         // magnitude of 𝒯 sets of t-way interactions
         uint16_t d;
@@ -106,13 +103,39 @@ class Parser
         // levels associated with each factor
         std::vector<uint16_t> levels;
 
-        // the array itself, only used when the --partial flag is given
-        std::vector<uint16_t*> array;
+        // the array itself, one row after another, only used when the --partial flag is given
+        std::vector<uint16_t> array;
+
+        // memory cap in MiB for remembering candidate row scores between rows, set by the --score-cache flag
+        uint64_t score_cache_mib = 64;
+
+        // memory cap in MiB for everything the generator builds, set by the --memory-budget flag; 0 means none
+        uint64_t memory_budget_mib = 0;
+
+        // longest time in seconds that added rows may wait before being written to the output file, set by
+        // the --flush-every flag; 0 means every row is written as soon as it is added
+        uint64_t flush_seconds = 1;
+
+        // seed for the random choices made while generating, set by the --seed flag; when has_seed is false,
+        // the current time is used instead
+        uint64_t seed = 0;
+        bool has_seed = false;
+
+        // whether the output file is written in the packed binary format, set by the --binary flag
+        bool binary = false;
+
+        // file to save checkpoints of the run into, set by the --checkpoint flag; empty means none are saved
+        std::string checkpoint_filename;
+
+        // how many rows are added between checkpoints, set by the --checkpoint-every flag
+        uint64_t checkpoint_every = 10;
+
+        // checkpoint to pick the run up from, set by the --resume flag; empty means the run starts fresh
+        std::string resume_filename;
 
         int32_t process_input();            // call this to process the input file
         Parser();                           // default constructor, probably won't be used
         Parser(int32_t argc, char *argv[]); // constructor to read arguments and flags
-        ~Parser();                      // deconstructor
 
     private:
         // input filename
@@ -124,14 +147,14 @@ class Parser
         // partial filename
         std::string partial_filename;
 
-        // partial array file
-        std::ifstream partial;
-
         void trim(std::string &s);  // trims a string of whitespace on either side
+        bool read_number(const std::string &option, const std::string &arg, uint64_t *number);
         void syntax_error(uint64_t lineno, std::string expected, std::string actual, bool verbose = true);
         void semantic_error(uint64_t lineno, uint64_t row, uint16_t col, uint16_t level, uint16_t value,
             int32_t neg_value = 0, bool verbose = true);
         void other_error(uint64_t lineno, std::string line, bool verbose = true);
+        void packed_error(std::string problem, bool verbose = true);
+        int32_t read_packed(const char *data, uint64_t size);
 };
 
 #endif // PARSER
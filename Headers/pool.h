@@ -0,0 +1,65 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This header contains a class used for running many small, independent tasks on a fixed set of worker    |
+| threads. The Array uses it to score candidate rows in parallel; rather than starting a new thread for     |
+| every row and joining them all in lockstep, the workers are started once and then kept busy for as long   |
+| as the Array exists. Each worker has its own queue of tasks. Tasks are handed out to the queues in turn,  |
+| and a worker that runs out of its own tasks steals from the back of another's queue, so one slow task     |
+| never holds up the rest. The total number of waiting tasks is bounded, so a producer that outpaces the    |
+| workers is made to wait instead of piling up an unbounded amount of memory.                               |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef POOL
+#define POOL
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool
+{
+    public:
+        void submit(std::function<void()> task);    // queues a task, waiting first if the queues are full
+        void wait();                                // waits until every submitted task has finished
+        uint32_t size() const;                      // number of worker threads
+
+        ThreadPool(uint32_t num_workers, uint64_t max_queued_o);    // constructor that starts the workers
+        ~ThreadPool();                                              // destructor that stops and joins them
+
+    private:
+        // a worker's own tasks; the owner takes from the front, and thieves take from the back
+        class WorkQueue
+        {
+            public:
+                std::mutex lock;
+                std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::thread> workers;
+        std::vector<WorkQueue*> queues;     // queues[i] belongs to workers[i]
+
+        // guards everything below; never held while a task runs
+        std::mutex state_mutex;
+        std::condition_variable work_ready;     // signalled when a task is queued, or when stopping
+        std::condition_variable space_ready;    // signalled when a queued task is taken
+        std::condition_variable all_done;       // signalled when the last unfinished task finishes
+
+        const uint64_t max_queued;  // upper bound on tasks queued but not yet taken by a worker
+        uint64_t queued = 0;        // tasks queued but not yet taken by a worker
+        uint64_t unfinished = 0;    // tasks submitted but not yet finished
+        uint64_t next_queue = 0;    // queue that the next submitted task goes to
+        bool stopping = false;      // set by the destructor to make the workers return
+
+        void work(uint32_t id);                                 // the loop run by each worker thread
+        bool take(uint32_t id, std::function<void()> *task);    // gets a task from own queue, or steals one
+};
+
+#endif // POOL
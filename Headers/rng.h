@@ -0,0 +1,32 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This header contains a class used for drawing random numbers, in place of rand(). It is xoshiro256**,   |
+| by David Blackman and Sebastiano Vigna: 256 bits of state, a few shifts and rotations per number, and a   |
+| period long enough to never matter here. Unlike rand(), every Rng has its own state, so nothing is hidden |
+| in the C library behind a lock, the same seed always gives the same numbers on every platform, and the    |
+| state is plain enough to be saved and restored as is (see checkpoint.cpp). An Rng is not meant to be      |
+| shared between threads; a thread that needs random numbers should be handed an Rng of its own.            |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef RNG
+#define RNG
+
+#include <cstdint>
+
+class Rng
+{
+    public:
+        uint64_t state[4];  // all there is to the generator; never all zeros
+
+        void seed(uint64_t seed_o);         // sets the state from a single number
+        uint64_t next();                    // draws a number from the whole 64-bit range
+        uint64_t below(uint64_t bound);     // draws a number from 0 to bound - 1, all equally likely
+
+        Rng(uint64_t seed_o = 0);
+};
+
+#endif // RNG
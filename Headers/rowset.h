@@ -0,0 +1,60 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This header contains a class used for tracking the set of rows (tests) in which something occurs. The   |
+| Single and Interaction classes each need to know in exactly which rows of the array they show up; a T set |
+| is identified by its rank alone, so its rows are only ever the union of its members', built when needed   |
+| (for now, only to list them in debug output). Since rows are numbered densely starting from 1, a growable |
+| bitset is a much better fit for this than a balanced tree: inserting a row is a single bit flip, the size |
+| is a count kept up to date as rows go in, and a union can be done a 64-bit word at a time. There is no    |
+| difference of row sets: the separations used for detection are counted row by row into their own table as |
+| rows are added (see array.h), so no two row sets ever need to be compared. The interface intentionally    |
+| mirrors the small subset of std::set<uint64_t> that the other modules were already using (insert, size,   |
+| range-based for loops) so that callers need not care about the layout.                                    |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef ROWSET
+#define ROWSET
+
+#include <cstdint>
+#include <vector>
+
+class RowSet
+{
+    public:
+        // forward iterator over the rows in the set, in increasing order; only meant for range-based for loops
+        class const_iterator
+        {
+            public:
+                uint64_t operator*() const;
+                const_iterator &operator++();
+                bool operator!=(const const_iterator &other) const;
+                const_iterator(const std::vector<uint64_t> *w, uint64_t idx, uint64_t cur);
+
+            private:
+                const std::vector<uint64_t> *words; // the words of the RowSet being iterated
+                uint64_t word_idx;                  // index of the word currently being iterated
+                uint64_t bits;                      // bits of that word not yet visited
+        };
+
+        void insert(uint64_t row);                              // adds a row to the set
+        uint64_t size() const;                                  // number of rows in the set
+        bool empty() const;                                     // whether the set has no rows
+        void unite(const RowSet &other);                        // this = this ∪ other
+        const_iterator begin() const;
+        const_iterator end() const;
+
+    private:
+        // bit (row % 64) of word (row / 64) is set when the row is in the set
+        std::vector<uint64_t> words;
+
+        // memoized popcount of all the words, kept up to date by every mutating method
+        uint64_t count = 0;
+
+        void recount();     // recomputes count from scratch after a word-parallel mutation
+};
+
+#endif // ROWSET
@@ -0,0 +1,64 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This header contains a class used for writing out the rows of the array as they are added, rather than  |
+| all at once when generation finishes. Each row is turned into text the moment it is written and kept in a |
+| buffer, which is handed to the file in one go whenever it grows past BUFFER_BYTES, or whenever a row is   |
+| written after the flush interval has gone by since the last time. That way a long run leaves behind every |
+| row it has added so far (give or take the last interval's worth) even if it is stopped early, without     |
+| paying for a system call on every row, and without ever holding a second copy of the whole array as text. |
+| A file can also be opened to take the rows in the packed binary format (see packed.h) instead of text;    |
+| the buffer then holds whole bytes of packed rows, with any bits left over kept aside for the next row.    |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef SINK
+#define SINK
+
+#include "packed.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class RowSink
+{
+    public:
+        bool open(const std::string &filename); // starts writing into a file, replacing whatever it had
+        bool open_packed(const std::string &filename, const PackedHeader &header);  // same, but packed
+        void open(std::FILE *stream);           // starts writing into a stream that someone else owns
+        bool is_open() const;                   // whether there is anywhere to write to
+        void write(const uint16_t *row, uint16_t num_factors);  // appends a row, flushing if it is time
+        bool flush();                           // hands everything buffered over to the file
+        bool close();                           // flushes, then closes the file if the sink opened it
+
+        // appends the text of a row: every value followed by a tab, then a newline
+        static void format(const uint16_t *row, uint16_t num_factors, std::string *text);
+
+        RowSink(uint64_t flush_seconds_o);
+        ~RowSink();
+
+    private:
+        static const uint64_t BUFFER_BYTES = 1 << 16;   // buffered text that forces a flush
+
+        std::FILE *file = nullptr;      // where rows go, or nullptr when not open
+        bool owned = false;             // whether file was opened by the sink, and so must be closed by it
+        bool failed = false;            // whether any write to file has failed so far
+        std::string buffer;             // text of the rows written since the last flush
+        uint64_t flush_seconds;         // longest time rows are held in buffer, as of the next row written
+        std::chrono::steady_clock::time_point last_flush;
+
+        // only used when writing packed rows
+        std::vector<uint8_t> widths;    // bits each column's values take; empty when writing text
+        uint64_t pending = 0;           // bits of the rows written so far that do not make a whole byte yet
+        uint8_t pending_bits = 0;       // how many bits pending has
+        uint64_t rows_written = 0;      // for the header, once the file is finished
+        uint64_t rows_offset = 0;       // where the number of rows is in the file
+
+        void pack(const uint16_t *row, uint16_t num_factors);
+};
+
+#endif // SINK
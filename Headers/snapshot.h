@@ -0,0 +1,73 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This header contains classes used for saving state to a binary file and reading it back, for the Array  |
+| checkpoints (see checkpoint.cpp). Everything is written in the byte order of the machine writing it, and  |
+| every vector is preceded by its length, so a reader can check that the sizes agree before filling them    |
+| in. The writer never touches the file it was asked for until everything has been written: it writes into  |
+| a temporary file beside it, which is renamed over the real one only once all of it made it to disk, so a  |
+| run that is stopped partway through writing still leaves the previous checkpoint behind, whole. The last  |
+| 8 bytes are a checksum of everything before them, so that a damaged file is turned away when it is read.  |
+|===========================================================================================================|
+*/
+
+#pragma once
+#ifndef SNAPSHOT
+#define SNAPSHOT
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// the checksum of nothing, which every checksum starts from; see snapshot.cpp
+const uint64_t SNAPSHOT_CHECKSUM_START = 0xcbf29ce484222325ULL;
+
+class SnapshotWriter
+{
+    public:
+        bool open(const std::string &filename);         // starts writing, into a temporary file for now
+        void put(const void *data, uint64_t bytes);     // writes raw bytes
+        void put_u64(uint64_t value);                   // writes one number
+        void put_u8s(const std::vector<uint8_t> &values);   // writes a vector, length first
+        void put_u16s(const std::vector<uint16_t> &values);
+        void put_u64s(const std::vector<uint64_t> &values);
+        bool commit();      // finishes writing, then puts the file in place; false if anything failed
+
+        ~SnapshotWriter();  // throws away the temporary file if commit() was never reached
+
+    private:
+        std::FILE *file = nullptr;  // the temporary file, while it is being written
+        std::string path;           // the file asked for
+        std::string temp_path;      // the file actually being written
+        bool failed = false;        // whether any write has failed so far
+        uint64_t checksum = SNAPSHOT_CHECKSUM_START;    // of everything written so far
+};
+
+class SnapshotReader
+{
+    public:
+        bool open(const std::string &filename);         // starts reading
+        bool get(void *data, uint64_t bytes);           // reads raw bytes
+        uint64_t get_u64();                             // reads one number, or 0 if there was none left
+        // these read a vector written by the matching put; when resize is false, the length read must be
+        // the vector's current size, and otherwise the vector is resized to it
+        bool get_u8s(std::vector<uint8_t> *values, bool resize = false);
+        bool get_u16s(std::vector<uint16_t> *values, bool resize = false);
+        bool get_u64s(std::vector<uint64_t> *values, bool resize = false);
+        bool at_end();      // whether everything went fine, the checksum matches, and nothing is left
+        bool ok() const;    // whether everything went fine so far
+
+        ~SnapshotReader();
+
+    private:
+        std::FILE *file = nullptr;  // the file being read
+        uint64_t remaining = 0;     // bytes not read yet, so that a bad length is caught before allocating
+        bool failed = false;        // whether any read has failed so far
+        uint64_t checksum = SNAPSHOT_CHECKSUM_START;    // of everything read so far
+
+        bool get_length(uint64_t size, uint64_t width, bool resize, uint64_t *length);
+};
+
+#endif // SNAPSHOT
@@ -1,5 +1,5 @@
 /* Array-Generator by Isaac Jung
-Last updated 12/22/2022
+Last updated 10/17/2026
 
 |===========================================================================================================|
 |   This file contains the meat of the project's logic. The constructor for the Array class takes a pointer |
@@ -25,77 +25,61 @@ Last updated 12/22/2022
 #include <time.h>
 
 // method forward declarations
+static bool next_colex(uint64_t *members, uint16_t k, uint64_t n);
+static uint64_t saturating_add(uint64_t a, uint64_t b);
+static uint64_t saturating_mul(uint64_t a, uint64_t b);
+static uint64_t saturating_choose(uint64_t n, uint64_t k);
+static double to_mib(uint64_t bytes);
 static void print_singles(Factor **factors, uint16_t num_factors);
 static void print_interactions(std::vector<Interaction*> interactions);
-static void print_sets(std::vector<T*> sets);
+static void print_sets(std::vector<Interaction*> interactions, uint16_t d);
 
 /* CONSTRUCTOR - initializes the object
- * - overloaded: this version can set its fields based on a premade vector of Single pointers
+ * - overloaded: this version can set its fields based on parameters
 */
-Interaction::Interaction(std::vector<Single*> *temp) : str_rep(this->to_string_internal(temp))
+SingleSpan::SingleSpan(Single **first_o, uint64_t count_o) : first(first_o), count(count_o)
 {
-    for (uint64_t i = 0; i < temp->size(); i++) singles.push_back(temp->at(i));
+    // nothing else to do
 }
 
-/* UTILITY METHOD: to_string - gets a string representation of the Interaction
- * 
- * returns:
- * - a string representing the Interaction
- *  --> This is not to be used for printing; rather, it is for mapping unique strings to their Interactions
-*/
-std::string Interaction::to_string() const
+Single **SingleSpan::begin() const
 {
-    return str_rep;
+    return first;
 }
 
-/* HELPER METHOD: to_string_internal - called by the constructor to build the string representation
- * - do not call outside of the constructor
- * 
- * returns:
- * - a string representing the Interaction
-*/
-std::string Interaction::to_string_internal(std::vector<Single*> *temp) const
+Single **SingleSpan::end() const
 {
-    std::string ret = "";
-    for (Single *single : *temp) ret += single->to_string();
-    return ret;
+    return first + count;
 }
 
-/* CONSTRUCTOR - initializes the object
- * - overloaded: this version can set its fields based on a premade vector of Interaction pointers
-*/
-T::T(std::vector<Interaction*> *temp) : str_rep(this->to_string_internal(temp))
+uint64_t SingleSpan::size() const
 {
-    for (uint64_t i = 0; i < temp->size(); i++) interactions.push_back(temp->at(i));
+    return count;
+}
 
-    // next, give all involved Interactions a reference to this set and this set a reference to its Singles
-    for (Interaction *interaction : *temp) {
-        interaction->sets.insert(this);
-        for (Single *single : interaction->singles) singles.push_back(single);
-    }
+Single *SingleSpan::operator[](uint64_t idx) const
+{
+    return first[idx];
 }
 
-/* UTILITY METHOD: to_string - gets a string representation of the T set
- * 
- * returns:
- * - a string representing the T set
- *  --> This is not to be used for printing; rather, it is for mapping unique strings to their T sets
+/* CONSTRUCTOR - initializes the object
+ * - overloaded: this version can set its fields based on a premade run of Single pointers
 */
-std::string T::to_string() const
+Interaction::Interaction(uint64_t r, Single **first, uint16_t t) : rank(r), singles(first, t)
 {
-    return str_rep;
+    // rows will be built later
 }
 
-/* HELPER METHOD: to_string_internal - called by the constructor to build the string representation
- * - do not call outside of the constructor
+/* UTILITY METHOD: to_string - gets a string representation of the Interaction
+ * - not memoized, since it is only needed for debug output
  * 
  * returns:
- * - a string representing the T set
+ * - a string representing the Interaction
 */
-std::string T::to_string_internal(std::vector<Interaction*> *temp) const
+std::string Interaction::to_string() const
 {
     std::string ret = "";
-    for (Interaction *interaction : *temp) ret += interaction->to_string();
+    for (Single *single : singles) ret += single->to_string();
     return ret;
 }
 
@@ -116,6 +100,10 @@ Array::Array()
     is_covering = false; is_locating = false; is_detecting = false;
     dont_cares = nullptr;
     permutation = nullptr;
+    pool = nullptr;
+    best_row_score = 0;
+    score_cache = nullptr;
+    score_cache_bytes = 0;
 }
 
 /* CONSTRUCTOR - initializes the object
@@ -123,7 +111,9 @@ Array::Array()
 */
 Array::Array(Parser *in) : Array::Array()
 {
-    srand(time(nullptr));   // seed rand() using current time
+    // seed rng as asked, or else using current time
+    seed = in->has_seed ? in->seed : static_cast<uint64_t>(time(nullptr));
+    rng.seed(seed);
     d = in->d; t = in->t; delta = in->delta;
     num_tests = 0;  // previously in->num_rows, but generation always starts from 0 rows
     num_factors = in->num_cols;
@@ -131,65 +121,76 @@ Array::Array(Parser *in) : Array::Array()
     permutation = new uint16_t[num_factors];
     for (uint16_t col = 0; col < num_factors; col++) permutation[col] = col;
     debug = in->debug; v = in->v; o = in->o; p = in->p;
+    score_cache_bytes = in->score_cache_mib > UINT64_MAX >> 20 ? UINT64_MAX : in->score_cache_mib << 20;
+    
+    uint64_t budget = in->memory_budget_mib > UINT64_MAX >> 20 ? UINT64_MAX : in->memory_budget_mib << 20;
+    if (!plan_memory(&in->levels, budget)) exit(1);
     
     if (o != silent) printf("Building internal data structures....\n");
     if (debug == d_on) printf("==%d== max_threads is %d\n", getpid(), max_threads);
+    if (debug == d_on) printf("==%d== seed is %lu\n", getpid(), seed);
+    if (debug == d_on) printf("==%d== coverage kernel is %s\n", getpid(), coverage_kernel.name());
     try {
         // build all Singles, associated with an array of Factors
-        factors = new Factor*[num_factors];
-        for (uint16_t i = 0; i < num_factors; i++) {
-            factors[i] = new Factor(i, in->levels.at(i), new Single*[in->levels.at(i)]);
-            for (uint16_t j = 0; j < factors[i]->level; j++) {
-                factors[i]->singles[j] = new Single(i, j);
-                singles.push_back(factors[i]->singles[j]);
-                single_map.insert({factors[i]->singles[j]->to_string(), factors[i]->singles[j]});
+        build_singles(&in->levels);
+        if (debug == d_on) print_singles(factors, num_factors);
+
+        // lay out the digits of the rows' keys for heuristic_all, unless there are too many rows for them
+        row_radix.assign(num_factors, 0);
+        uint64_t place = 1;
+        for (uint16_t col = num_factors; col > 0; col--) {
+            row_radix[col-1] = place;
+            if (place > UINT64_MAX/factors[col-1]->level) {
+                row_radix.clear();
+                break;
             }
+            place *= factors[col-1]->level;
         }
-        if (debug == d_on) print_singles(factors, num_factors);
+
+        // the rest is split into chunks that the workers build in parallel, or all in this thread if they
+        // could not be started
+        start_pool();
 
         // build all Interactions
-        std::vector<Single*> temp_singles;
-        build_t_way_interactions(0, t, &temp_singles);
+        std::vector<uint16_t> temp_cols, tuple_cols;
+        reserve_interactions();
+        build_t_way_interactions(0, t, &temp_cols, &tuple_cols);
+        fill_interactions(&tuple_cols);
         if (debug == d_on) print_interactions(interactions);
         total_problems += interactions.size();  // to account for all the coverage problems
         coverage_problems += interactions.size();
         score += interactions.size();   // the array is considered completed when this reaches 0
         if (p == c_only) return;    // no need to spend effort building Ts if they won't be used
 
-        // build all Ts
-        std::vector<Interaction*> temp_interactions;
-        build_size_d_sets(0, d, &temp_interactions);
-        if (debug == d_on) print_sets(sets);
-        for (T *t_set : sets) {
-            for (Single *s : t_set->singles) {
-                factors[s->factor]->l_issues += sets.size();
-                s->l_issues += sets.size();
-                total_problems += sets.size();
-            }
-            for (T *other_set : sets) {
-                if (t_set == other_set) continue;
-                t_set->location_conflicts.insert(other_set);
-            }
+        // count all Ts
+        build_size_d_sets();
+        if (debug == d_on) print_sets(interactions, d);
+        // every T set gives each of its Singles (counted once per Interaction of the set it appears in)
+        // num_sets location issues; a Single in c Interactions appears that way in c*C(n-1, d-1) T sets, so
+        // the totals are known without visiting every set
+        uint64_t sets_per_interaction = d > 0 ? choose(interactions.size() - 1, d - 1) : 0;
+        for (Single *s : singles) {
+            uint64_t issues = c_issues[s->id] * sets_per_interaction * num_sets;
+            factors[s->factor]->l_issues += issues;
+            l_issues[s->id] += issues;
+            total_problems += issues;
         }
-        total_problems += sets.size();  // to account for all the location problems
-        location_problems += sets.size();
+        // every T set starts out in class 0, the class of T sets that have not occurred in any row yet
+        set_order.resize(num_sets);
+        set_position.resize(num_sets);
+        for (uint64_t rank = 0; rank < num_sets; rank++) set_order[rank] = set_position[rank] = rank;
+        set_class.assign(num_sets, 0);
+        class_start.assign(1, 0);
+        class_size.assign(1, num_sets);
+        class_split.assign(1, 0);
+        unseen_sets.assign(interactions.size(), sets_per_interaction);
+        total_problems += num_sets; // to account for all the location problems
+        location_problems += num_sets;
         score = total_problems; // need to update this
         if (p != all) return;   // can skip the following stuff if not doing detection
 
-        // build all Interactions' maps of detection issues to their deltas (row difference magnitudes)
-        for (Interaction *i : interactions) {   // for all Interactions in the array
-            for (T *t_set : sets) { // for every T set this Interaction is NOT part of
-                if (i->sets.find(t_set) == i->sets.end()) {
-                    i->deltas.insert({t_set, 0});
-                    for (Single *s: i->singles) {
-                        factors[s->factor]->d_issues += delta;
-                        s->d_issues += delta;
-                        total_problems += delta;
-                        score += delta;
-                    }
-                }
-            }
-        }
+        // build the table of separations (row difference magnitudes) of every Interaction from every T set
+        build_separations();
         total_problems += interactions.size();  // to account for all the detection issues
         detection_problems += interactions.size();
         score += interactions.size();   // need to update this one last time
@@ -200,84 +201,199 @@ Array::Array(Parser *in) : Array::Array()
     }
 }
 
-/* CONSTRUCTOR - initializes the object
- * - overloaded: this version can set its private fields based on existing data
- *  --> intended to be used ONLY BY Array::clone()
-*/
-Array::Array(uint64_t total_problems_o, uint64_t coverage_problems_o, uint64_t location_problems_o,
-    uint64_t detection_problems_o, std::vector<uint16_t*> *rows_o, uint64_t num_tests_o,
-    uint16_t num_factors_o, Factor **factors_o, prop_mode p_o, uint16_t d_o, uint16_t t_o, uint16_t delta_o):
-    Array::Array()
-{
-    total_problems = total_problems_o;
-    coverage_problems = coverage_problems_o;
-    location_problems = location_problems_o;
-    detection_problems = detection_problems_o;
-    d = d_o; t = t_o; delta = delta_o;
-    num_tests = num_tests_o; num_factors = num_factors_o;
-    o = silent; p = p_o;
-    memory_mutex.lock();
-    try {
-        for (uint16_t *row_o : *rows_o) {
-            uint16_t *row = new uint16_t[num_factors];
-            for (uint16_t col = 0; col < num_factors; col++) row[col] = row_o[col];
-            rows.push_back(row);
-        }
-        factors = new Factor*[num_factors];
-        for (uint16_t i = 0; i < num_factors; i++) {
-            factors[i] = new Factor(i, factors_o[i]->level, new Single*[factors_o[i]->level]);
-            for (uint16_t j = 0; j < factors[i]->level; j++) {
-                factors[i]->singles[j] = new Single(i, j);
-                singles.push_back(factors[i]->singles[j]);
-                single_map.insert({factors[i]->singles[j]->to_string(), factors[i]->singles[j]});
-            }
+/* HELPER METHOD: plan_memory - estimates the memory the array will need, and fits the run into a budget
+ * - called before anything big is built, using only the counts of what will be built, so that a problem
+ *   too big for the budget is turned away right away instead of after hours of running
+ * - the estimate has the structures built up front, the scratch space each thread scoring rows for
+ *   heuristic_all() needs, and what every added row costs (mostly a bit in each Interaction's RowSet);
+ *   it is close, not exact, since it leaves out small things like the vectors of pointers to the Factors
+ * - a budget must hold the structures, one scoring thread (the lighter heuristics cannot finish an array
+ *   on their own), and the fewest rows any array could have: the product of the t largest levels; what is
+ *   left over after that is shared out: up to half to as many more threads as fit, then up to half of the
+ *   rest to the score cache (never more than the --score-cache cap), and the rest to more rows
+ * 
+ * parameters:
+ * - levels: pointer to vector holding the number of levels of each factor
+ * - budget: memory cap in bytes for the whole run, or 0 for none
+ * 
+ * returns:
+ * - false if the budget is too small (after printing why), true otherwise
+ *  --> when true, max_threads and score_cache_bytes will have been fit to the budget
+*/
+bool Array::plan_memory(std::vector<uint16_t> *levels, uint64_t budget)
+{
+    // count what is going to be built, saturating at UINT64_MAX instead of overflowing
+    uint64_t num_singles = 0;
+    std::vector<uint64_t> counts(t + 1, 0), tuples(t + 1, 0);   // k-way interactions, and k-tuples of columns
+    counts[0] = tuples[0] = 1;
+    for (uint16_t level : *levels) {
+        num_singles += level;
+        for (uint16_t k = t; k > 0; k--) {
+            counts[k] = saturating_add(counts[k], saturating_mul(counts[k - 1], level));
+            tuples[k] = saturating_add(tuples[k], tuples[k - 1]);
         }
-        std::vector<Single*> temp_singles;
-        build_t_way_interactions(0, t, &temp_singles);
-        if (p == c_only) return;
-        std::vector<Interaction*> temp_interactions;
-        build_size_d_sets(0, d, &temp_interactions);
-    } catch (const std::bad_alloc &e) { // give up and free memory for now, caller can wait for other threads
-        for (uint64_t i = 0; i < num_tests; i++) delete[] rows[i];
-        for (uint16_t i = 0; i < num_factors; i++) delete factors[i];
-        delete[] factors;
-        for (Interaction *i : interactions) delete i;
-        for (T *t_set : sets) delete t_set;
-        delete[] dont_cares;
-        delete[] permutation;
-        scores_mutex.unlock();
-        throw e;
-    }
-    scores_mutex.unlock();
+    }
+    uint64_t n = counts[t], row_size = tuples[t];   // a row has an Interaction for every tuple of columns
+    uint64_t sets = p == c_only ? 0 : saturating_choose(n, d);
+    uint64_t sets_per_interaction = p == c_only ? 0 : saturating_choose(n - 1, d - 1);
+
+    // bytes for the Singles, Interactions, T sets, and separations, in that order
+    uint64_t parts[4] = {0, 0, 0, 0};
+    parts[0] = num_singles*(sizeof(Single) + sizeof(Single*) + 8*sizeof(uint64_t));
+    parts[1] = saturating_add(
+        saturating_mul(n, sizeof(Interaction) + sizeof(Interaction*) + t*(sizeof(Single*) + 1) + 2 +
+            3*sizeof(uint64_t)),
+        saturating_mul(row_size, sizeof(uint64_t) + t*sizeof(uint16_t)));
+    if (p != c_only)    // set_order, set_position, set_class, up to one class per T set, and unseen_sets
+        parts[2] = saturating_add(saturating_mul(sets, 6*sizeof(uint64_t)),
+            saturating_mul(n, (d + 2)*sizeof(uint64_t)));
+    if (p == all)       // separations, active_blocks, active_block_count, and row_set_bits
+        parts[3] = saturating_add(saturating_mul(n, saturating_add(sets, (sets/4096 + 2)*sizeof(uint64_t))),
+            sets/8);
+    uint64_t fixed = 0;
+    for (uint64_t part : parts) fixed = saturating_add(fixed, part);
+    uint64_t per_thread = saturating_add(3*num_singles*sizeof(uint64_t) + 2*row_size*sizeof(uint64_t),
+        saturating_mul(saturating_mul(row_size, sets_per_interaction), 3*sizeof(uint64_t)));
+    uint64_t per_row = n/4 + num_singles/4 + levels->size()*sizeof(uint16_t);  // RowSets grow in doublings
+    
+    // the fewest rows any array could have, as every t-way interaction of the t largest factors needs a row
+    std::vector<uint16_t> largest(*levels);
+    std::sort(largest.begin(), largest.end(), std::greater<uint16_t>());
+    uint64_t least_rows = 1;
+    for (uint16_t col = 0; col < t; col++) least_rows = saturating_mul(least_rows, largest[col]);
+    uint64_t least = saturating_add(saturating_add(fixed, per_thread), saturating_mul(least_rows, per_row));
+
+    if (debug == d_on) {
+        printf("==%d== Estimated memory: %.1f MiB to build (Singles %.1f, Interactions %.1f, T sets %.1f, ",
+            getpid(), to_mib(fixed), to_mib(parts[0]), to_mib(parts[1]), to_mib(parts[2]));
+        printf("separations %.1f), %.1f MiB per scoring thread, %.1f KiB per row\n", to_mib(parts[3]),
+            to_mib(per_thread), to_mib(per_row)*1024);
+    }
+    if (budget == 0) return true;
+    if (least > budget) {
+        printf("\t-- ERROR --\n\tThe memory budget of %.1f MiB is too small; ", to_mib(budget));
+        printf("this array needs at least %.1f MiB:\n", to_mib(least));
+        printf("\t%.1f MiB for its data structures (Singles %.1f, Interactions %.1f, T sets %.1f, separations ",
+            to_mib(fixed), to_mib(parts[0]), to_mib(parts[1]), to_mib(parts[2]));
+        printf("%.1f),\n\t%.1f MiB for a thread to score rows, ", to_mib(parts[3]), to_mib(per_thread));
+        printf("and %.1f MiB for the fewest rows possible (%lu).\n",
+            to_mib(saturating_mul(least_rows, per_row)), least_rows);
+        printf("\tTry a larger budget, or an array with smaller parameters.\n\n");
+        return false;
+    }
+
+    uint64_t left = budget - least;
+    uint32_t threads = 1;
+    while (threads < max_threads && saturating_mul(threads, per_thread) <= left/2) threads++;
+    left -= (threads - 1)*per_thread;
+    if (score_cache_bytes > left/2) score_cache_bytes = left/2;
+    left -= score_cache_bytes;
+    max_threads = threads;
+    if (o != silent) {
+        printf("Estimated memory: %.1f MiB to build, then about %.1f KiB per row.\n", to_mib(fixed),
+            to_mib(per_row)*1024);
+        printf("Within the budget of %.1f MiB: %u thread(s) with a %.1f MiB score cache, and room for about ",
+            to_mib(budget), threads, to_mib(score_cache_bytes));
+        printf("%lu rows.\n", per_row == 0 ? UINT64_MAX : saturating_add(least_rows, left/per_row));
+    }
+    return true;
+}
+
+/* HELPER METHOD: build_singles - initializes the factors array along with the arena of Singles
+ * - this method should not be called more than once
+ *
+ * parameters:
+ * - levels: pointer to vector holding the number of levels of each factor
+ *
+ * returns:
+ * - void, but after the method finishes, the factors array and singles vector will be initialized
+*/
+void Array::build_singles(std::vector<uint16_t> *levels)
+{
+    uint64_t total = 0;
+    for (uint16_t level : *levels) total += level;
+    single_arena.reserve(total);    // never grows past this, so pointers into it stay valid
+    factors = new Factor*[num_factors]{nullptr};
+    for (uint16_t i = 0; i < num_factors; i++) {
+        uint64_t first = single_arena.size();
+        for (uint16_t j = 0; j < levels->at(i); j++) {
+            single_arena.emplace_back(i, j, static_cast<uint32_t>(single_arena.size()));
+            singles.push_back(&single_arena.back());
+        }
+        factors[i] = new Factor(i, levels->at(i), &single_arena[first]);
+    }
+    c_issues.assign(total, 0);
+    l_issues.assign(total, 0);
+    d_issues.assign(total, 0);
+}
+
+/* HELPER METHOD: reserve_interactions - counts the t-way interactions and sizes their arenas accordingly
+ * - the factors array must be initialized before calling this method
+ * - call right before build_t_way_interactions(), which must not grow the arenas past what is reserved here
+ *
+ * returns:
+ * - void, but after the method finishes, there will be room for every Interaction, and tuple_binomials will
+ *   be initialized
+ *  --> throws std::bad_alloc when there are too many interactions to even count
+*/
+void Array::reserve_interactions()
+{
+    std::vector<uint64_t> counts(t + 1, 0); // counts[k] is the number of k-way interactions seen so far
+    counts[0] = 1;
+    for (uint16_t col = 0; col < num_factors; col++)
+        for (uint16_t k = t; k > 0; k--) {
+            if (counts[k - 1] > (UINT64_MAX - counts[k])/factors[col]->level) throw std::bad_alloc();
+            counts[k] += counts[k - 1]*factors[col]->level;
+        }
+    if (counts[t] > interaction_singles.max_size()/(t > 0 ? t : 1)) throw std::bad_alloc();
+    tuple_binomials.assign((t + 1)*(num_factors + 1), 0);
+    for (uint16_t n = 0; n <= num_factors; n++) {
+        tuple_binomials[n] = 1;
+        for (uint16_t k = 1; k <= t && k <= n; k++) {  // Pascal's rule, saturating
+            uint64_t left = tuple_binomials[(k - 1)*(num_factors + 1) + n - 1];
+            uint64_t right = tuple_binomials[k*(num_factors + 1) + n - 1];
+            tuple_binomials[k*(num_factors + 1) + n] = left > UINT64_MAX - right ? UINT64_MAX : left + right;
+        }
+    }
+    interaction_arena.reserve(counts[t]);
+    interaction_singles.assign(counts[t]*t, nullptr);
+    interactions.reserve(counts[t]);
+    is_covered.assign(counts[t], 0);
+    uncovered_views.assign(t*counts[t] + CoverageKernel::PADDING, 1);
+    is_detectable.assign(counts[t], 0);
 }
 
 /* HELPER METHOD: build_t_way_interactions - initializes the interactions vector recursively
  * - the factors array must be initialized before calling this method
- * - top down recursive; auxiliary caller should use 0, t, and an empty vector as initial parameters
+ * - top down recursive; auxiliary caller should use 0, t, and empty vectors as initial parameters
  *   --> do not use the interactions vector itself as the parameter
  * - this method should not be called more than once
+ * - interactions are grouped by column tuple, with the tuples in lexicographic order; within a tuple, the
+ *   interactions are in mixed-radix order of their values (first column most significant), so that the
+ *   index of any interaction is tuple_offsets[tuple rank] + its mixed-radix value index
+ * - this only lays the interactions out; fill_interactions() must be called after it to give them Singles
  * 
  * parameters:
  * - start: left side of factors array at which to begin the outer for loop
  * - t: desired strength of interactions
- * - singles_so_far: auxiliary vector of pointers used to track the current combination of Singles
+ * - cols_so_far: auxiliary vector used to track the current combination of columns
+ * - tuple_cols: vector to which the columns of every tuple are appended, t at a time, in tuple order
  * 
  * returns:
  * - void, but after the method finishes, the array's interactions vector will be initialized
 */
-void Array::build_t_way_interactions(uint16_t start, uint16_t t_cur, std::vector<Single*> *singles_so_far)
+void Array::build_t_way_interactions(uint16_t start, uint16_t t_cur, std::vector<uint16_t> *cols_so_far,
+    std::vector<uint16_t> *tuple_cols)
 {
-    // base case: interaction is completed and ready to store
+    // base case: column tuple is completed, so make room for every interaction over it
     if (t_cur == 0) {
-        Interaction *new_interaction = new Interaction(singles_so_far);
-        if (!new_interaction) throw std::bad_alloc();   // will unwind to original caller who should handle
-        interactions.push_back(new_interaction);
-        interaction_map.insert({new_interaction->to_string(), new_interaction});    // for later accessing
-        for (Single *single : new_interaction->singles) {
-            factors[single->factor]->c_issues++;
-            single->c_issues++;
-            total_problems++;
-            score++;
+        tuple_offsets.push_back(interactions.size());
+        tuple_cols->insert(tuple_cols->end(), cols_so_far->begin(), cols_so_far->end());
+        uint64_t combos = 1;    // number of value combinations the tuple can take on
+        for (uint16_t col : *cols_so_far) combos *= factors[col]->level;
+        for (uint64_t value_idx = 0; value_idx < combos; value_idx++) {
+            interaction_arena.emplace_back(interactions.size(), &interaction_singles[interactions.size()*t], t);
+            interactions.push_back(&interaction_arena.back());
         }
         return;
     }
@@ -285,76 +401,437 @@ void Array::build_t_way_interactions(uint16_t start, uint16_t t_cur, std::vector
     // recursive case: need to introduce another loop for higher strength
     uint16_t end = num_factors - t_cur + 1;
     for (uint16_t col = start; col < end; col++) {
-        for (uint16_t level = 0; level < factors[col]->level; level++) {
-            singles_so_far->push_back(factors[col]->singles[level]);    // note these are Single *
-            build_t_way_interactions(col+1, t_cur-1, singles_so_far);
-            singles_so_far->pop_back();
-        }
+        cols_so_far->push_back(col);
+        build_t_way_interactions(col+1, t_cur-1, cols_so_far, tuple_cols);
+        cols_so_far->pop_back();
     }
 }
 
-/* HELPER METHOD: build_size_d_sets - initializes the sets set recursively (a set of sets of interactions)
- * - the interactions vector must be initialized before calling this method
- * - top down recursive; auxiliary caller should use 0, d, and an empty set as initial parameters
- *   --> do not use the sets set itself as the parameter
- * - this method should not be called more than once
+/* HELPER METHOD: fill_interactions - gives every Interaction its Singles and counts their coverage issues
+ * - call right after build_t_way_interactions(), with the tuple columns it gathered
+ * - tuples are split into chunks built in parallel; each chunk counts coverage issues on its own, and the
+ *   counts are merged once all chunks are done
  * 
  * parameters:
- * - start: left side of interactions vector at which to begin the for loop
- * - d: desired magnitude of sets
- * - interactions_so_far: auxiliary vector of pointers used to track the current combination of Interactions
+ * - tuple_cols: the columns of every tuple, t at a time, in tuple order
  * 
  * returns:
- * - void, but after the method finishes, the array's sets set will be initialized
+ * - void, but after the method finishes, every Interaction will have its Singles, and every Single and
+ *   Factor will have its coverage issues (which, for a Single, start out as its interaction_counts)
 */
-void Array::build_size_d_sets(uint16_t start, uint16_t d_cur, std::vector<Interaction*> *interactions_so_far)
+void Array::fill_interactions(std::vector<uint16_t> *tuple_cols)
 {
-    // base case: set is completed and ready to store
-    if (d_cur == 0) {
-        T *new_set = new T(interactions_so_far);
-        if (!new_set) throw std::bad_alloc();   // will unwind to original caller who should handle
-        sets.push_back(new_set);
-        t_set_map.insert({new_set->to_string(), new_set});  // for later accessing
-        return;
+    uint64_t chunks = chunk_count(tuple_offsets.size());
+    std::vector<uint64_t> counts(chunks*singles.size(), 0); // per chunk, Interactions each Single is part of
+    run_chunks(tuple_offsets.size(), chunks, [this, tuple_cols, &counts](uint64_t begin, uint64_t end,
+        uint64_t chunk) {
+        uint64_t *count = &counts[chunk*singles.size()];
+        for (uint64_t tuple = begin; tuple < end; tuple++) {
+            uint16_t *cols = &tuple_cols->at(tuple*t);
+            uint64_t last = tuple + 1 < tuple_offsets.size() ? tuple_offsets[tuple + 1] : interactions.size();
+            for (uint64_t rank = tuple_offsets[tuple]; rank < last; rank++) {
+                uint64_t remaining = rank - tuple_offsets[tuple];   // peel off the mixed-radix digits
+                for (uint16_t j = t; j-- > 0;) {
+                    Factor *f = factors[cols[j]];
+                    Single *single = &f->singles[remaining % f->level];
+                    interaction_singles[rank*t + j] = single;
+                    count[single->id]++;
+                    remaining /= f->level;
+                }
+            }
+        }
+    });
+
+    interaction_counts.assign(singles.size(), 0);
+    for (uint64_t chunk = 0; chunk < chunks; chunk++)
+        for (Single *s : singles) {
+            uint64_t issues = counts[chunk*singles.size() + s->id];
+            interaction_counts[s->id] += issues;
+            factors[s->factor]->c_issues += issues;
+            c_issues[s->id] += issues;
+            total_problems += issues;
+            score += issues;
+        }
+}
+
+/* HELPER METHOD: build_size_d_sets - counts the size-d sets of interactions and prepares for ranking them
+ * - the interactions vector must be initialized before calling this method
+ * - this method should not be called more than once
+ * - T sets are never stored; a T set is the d-subset {m_0 < m_1 < ... < m_(d-1)} of interaction indices
+ *   whose colexicographic rank is C(m_0, 1) + C(m_1, 2) + ... + C(m_(d-1), d) (see rank_set())
+ *
+ * returns:
+ * - void, but after the method finishes, num_sets and the table of binomial coefficients will be initialized
+ *  --> throws std::bad_alloc when there are too many sets to even count
+*/
+void Array::build_size_d_sets()
+{
+    uint64_t n = interactions.size();
+    set_binomials.assign((static_cast<uint64_t>(d) + 1)*(n + 1), 0);
+    for (uint64_t row = 0; row <= n; row++) {   // Pascal's triangle, saturating instead of overflowing
+        set_binomials[row] = 1;
+        for (uint16_t k = 1; k <= d && k <= row; k++) {
+            uint64_t a = set_binomials[(k - 1)*(n + 1) + row - 1], b = set_binomials[k*(n + 1) + row - 1];
+            set_binomials[k*(n + 1) + row] = a > UINT64_MAX - b ? UINT64_MAX : a + b;
+        }
     }
+    num_sets = choose(n, d);
+    if (num_sets == UINT64_MAX) throw std::bad_alloc(); // too many to rank, let alone track
+}
+
+/* HELPER METHOD: build_separations - initializes the table of separations and the detection issues
+ * - build_size_d_sets() must be called before this method
+ * - this method should not be called more than once
+ * - Interactions are split into chunks built in parallel; each Interaction only writes to its own part of
+ *   the table, and each chunk counts detection issues on its own, so the counts are merged once all chunks
+ *   are done
+ *
+ * returns:
+ * - void, but after the method finishes, separations and the active blocks will be initialized, and every
+ *   Single and Factor will have its detection issues
+ *  --> throws std::bad_alloc when the table would not fit in memory
+*/
+void Array::build_separations()
+{
+    if (num_sets > SIZE_MAX/interactions.size()) throw std::bad_alloc();
+    separations.assign(interactions.size()*num_sets, 0);
+    active_words = ((num_sets + 63)/64 + 63)/64;
+    active_blocks.assign(interactions.size()*active_words, 0);
+    active_block_count.assign(interactions.size(), 0);
+    row_set_bits.assign((num_sets + 63)/64, 0);
+
+    uint64_t chunks = chunk_count(interactions.size());
+    std::vector<uint64_t> counts(chunks*singles.size(), 0); // per chunk, detection issues of each Single
+    run_chunks(interactions.size(), chunks, [this, &counts](uint64_t begin, uint64_t end, uint64_t chunk) {
+        uint64_t *count = &counts[chunk*singles.size()];
+        std::vector<uint64_t> own_sets; // T sets an Interaction is part of are not detection issues for it
+        for (uint64_t i_rank = begin; i_rank < end; i_rank++) {
+            uint8_t *sep = &separations[i_rank*num_sets];
+            own_sets.clear();
+            sets_containing(i_rank, &own_sets);
+            for (uint64_t rank : own_sets) sep[rank] = static_cast<uint8_t>(delta);
+            uint64_t *active = &active_blocks[i_rank*active_words];
+            for (uint64_t block = 0; block*64 < num_sets; block++)
+                for (uint64_t rank = block*64; rank < num_sets && rank < (block + 1)*64; rank++)
+                    if (sep[rank] < delta) {    // some separation is needed in this block
+                        active[block/64] |= static_cast<uint64_t>(1) << (block & 63);
+                        active_block_count[i_rank]++;
+                        break;
+                    }
+            for (Single *s : interactions[i_rank]->singles) // every other T set is delta issues for each Single
+                count[s->id] += delta * (num_sets - own_sets.size());
+        }
+    });
+
+    for (uint64_t chunk = 0; chunk < chunks; chunk++)
+        for (Single *s : singles) {
+            uint64_t issues = counts[chunk*singles.size() + s->id];
+            factors[s->factor]->d_issues += issues;
+            d_issues[s->id] += issues;
+            total_problems += issues;
+            score += issues;
+        }
+}
 
-    // recursive case: need to introduce another loop for higher magnitude
-    for (uint16_t i = start; i < interactions.size() - d_cur + 1; i++) {
-        interactions_so_far->push_back(interactions[i]);    // note these are Interaction *
-        build_size_d_sets(i+1, d_cur-1, interactions_so_far);
-        interactions_so_far->pop_back();
+/* UTILITY METHOD: choose - looks up a binomial coefficient
+ *
+ * parameters:
+ * - n: size of the pool, at most interactions.size()
+ * - k: number chosen from the pool, at most d
+ *
+ * returns:
+ * - C(n, k), or UINT64_MAX if that does not fit in 64 bits
+*/
+uint64_t Array::choose(uint64_t n, uint16_t k) const
+{
+    return set_binomials[k*(interactions.size() + 1) + n];
+}
+
+/* UTILITY METHOD: rank_set - gets the rank of the T set with the given members
+ *
+ * parameters:
+ * - members: pointer to d interaction indices, in increasing order
+ *
+ * returns:
+ * - the colexicographic rank of the set, in the range [0, num_sets)
+*/
+uint64_t Array::rank_set(uint64_t *members) const
+{
+    uint64_t rank = 0;
+    for (uint16_t j = 0; j < d; j++) rank += choose(members[j], j + 1);
+    return rank;
+}
+
+/* UTILITY METHOD: unrank_set - recovers the members of the T set with the given rank
+ * - greedy: the largest member is the largest m with C(m, d) <= rank, then repeat on what is left
+ *
+ * parameters:
+ * - rank: rank of the set, in the range [0, num_sets)
+ * - members: pointer to space for d interaction indices, which will be filled in increasing order
+ *
+ * returns:
+ * - void, but after the method finishes, members will hold the set's interaction indices
+*/
+void Array::unrank_set(uint64_t rank, uint64_t *members) const
+{
+    uint64_t upper = interactions.size();
+    for (uint16_t k = d; k > 0; k--) {
+        uint64_t lo = k - 1, hi = upper;    // C(lo, k) = 0 <= rank always holds
+        while (hi - lo > 1) {
+            uint64_t mid = lo + (hi - lo)/2;
+            if (choose(mid, k) <= rank) lo = mid;
+            else hi = mid;
+        }
+        members[k - 1] = lo;
+        rank -= choose(lo, k);
+        upper = lo;
+    }
+}
+
+/* UTILITY METHOD: sets_containing - finds the ranks of every T set containing a given interaction
+ * - this replaces storing the sets in each Interaction; there are C(n-1, d-1) of them
+ *
+ * parameters:
+ * - member: index of the interaction
+ * - ranks: vector onto the end of which the ranks will be appended, in no particular order
+ *
+ * returns:
+ * - void, but after the method finishes, ranks will have the new entries
+*/
+void Array::sets_containing(uint64_t member, std::vector<uint64_t> *ranks) const
+{
+    uint64_t n = interactions.size();
+    if (d == 0 || n < d) return;
+    uint16_t k = d - 1; // number of other members to choose, from among the n-1 other interactions
+    std::vector<uint64_t> others(k), members(d);
+    for (uint16_t j = 0; j < k; j++) others[j] = j;
+    while (true) {
+        // merge the chosen others (shifted past member) and member itself into increasing order
+        uint16_t m = 0;
+        bool placed = false;
+        for (uint16_t j = 0; j < k; j++) {
+            uint64_t idx = others[j] >= member ? others[j] + 1 : others[j];
+            if (!placed && member < idx) {
+                members[m++] = member;
+                placed = true;
+            }
+            members[m++] = idx;
+        }
+        if (!placed) members[m] = member;
+        ranks->push_back(rank_set(members.data()));
+        if (!next_colex(others.data(), k, n - 1)) break;
     }
 }
 
+/* UTILITY METHOD: tuple_rank - gets the rank of a column tuple, in the order used by tuple_offsets
+ * - tuples are in lexicographic order, which is the reverse of the colexicographic order of the tuples
+ *   {num_factors-1 - c : c in the tuple}; hence the rank is C(num_factors, t) - 1 minus the colex rank of those
+ *
+ * parameters:
+ * - cols: pointer to t columns, in increasing order
+ *
+ * returns:
+ * - the rank of the tuple, in the range [0, tuple_offsets.size())
+*/
+uint64_t Array::tuple_rank(uint16_t *cols) const
+{
+    uint64_t rank = tuple_offsets.size() - 1;
+    for (uint16_t j = 0; j < t; j++)
+        rank -= tuple_binomials[(t - j)*(num_factors + 1) + num_factors - 1 - cols[j]];
+    return rank;
+}
+
+/* UTILITY METHOD: interactions_containing - gets the rank of every Interaction that a Single is part of
+ * - goes through the column tuples including the Single's factor; within each, the Single's value fixes one
+ *   mixed-radix digit, so the Interactions containing it come in evenly spaced runs
+ *
+ * parameters:
+ * - s: the Single
+ * - ranks: pointer to vector to which the ranks should be appended, in no particular order
+ *
+ * returns:
+ * - void, but after the method finishes, ranks will hold the rank of every Interaction containing s
+*/
+void Array::interactions_containing(Single *s, std::vector<uint64_t> *ranks) const
+{
+    uint16_t k = t - 1; // number of other columns to choose, from among the num_factors-1 other columns
+    std::vector<uint64_t> others(k);
+    std::vector<uint16_t> cols(t);
+    for (uint16_t j = 0; j < k; j++) others[j] = j;
+    while (true) {
+        // merge the chosen others (shifted past the factor) and the factor itself into increasing order
+        uint16_t m = 0, at = k;
+        for (uint16_t j = 0; j < k; j++) {
+            uint16_t col = static_cast<uint16_t>(others[j] >= s->factor ? others[j] + 1 : others[j]);
+            if (at == k && s->factor < col) {
+                at = m;
+                cols[m++] = s->factor;
+            }
+            cols[m++] = col;
+        }
+        if (at == k) cols[m] = s->factor;
+
+        // the digits before the factor's count the runs, and the digits after it make up each run
+        uint64_t runs = 1, run_length = 1;
+        for (uint16_t j = 0; j < at; j++) runs *= factors[cols[j]]->level;
+        for (uint16_t j = at + 1; j < t; j++) run_length *= factors[cols[j]]->level;
+        uint64_t first = tuple_offsets[tuple_rank(cols.data())] + s->value*run_length;
+        for (uint64_t run = 0; run < runs; run++)
+            for (uint64_t idx = 0; idx < run_length; idx++)
+                ranks->push_back(first + run*run_length*factors[s->factor]->level + idx);
+        if (!next_colex(others.data(), k, num_factors - 1)) break;
+    }
+}
+
+/* UTILITY METHOD: set_to_string - gets a string representation of the T set with the given rank
+ *
+ * returns:
+ * - a string representing all Interactions in the set
+ *  --> This is only meant for debug output, since ranks are what identify T sets
+*/
+std::string Array::set_to_string(uint64_t rank) const
+{
+    std::vector<uint64_t> members(d);
+    unrank_set(rank, members.data());
+    std::string ret = "";
+    for (uint64_t m : members) ret += interactions[m]->to_string();
+    return ret;
+}
+
 /* HELPER METHOD: build_row_interactions - recovers the Interaction objects based on the given row
- * - top down recursive; auxiliary caller should use 0, t, and an empty string as initial parameters
- * - this method should be called for every unique row considered; note that this gets expensive
+ * - this method should be called for every unique row considered, so it avoids any allocation besides the
+ *   one reserve() on the output vector; each Interaction is found with arithmetic on its rank (see below)
+ * 
+ * parameters:
+ * - row: integer array representing a row up for consideration for appending to the array
+ * - row_interactions: initially empty vector to hold the Interactions as they are recovered
+ * 
+ * returns:
+ * - void, but after the method finishes, row_interactions will hold all the interactions in the row, in the
+ *   same order as the interactions vector (so it has no duplicates and is sorted by rank)
+*/
+void Array::build_row_interactions(uint16_t *row, std::vector<Interaction*> *row_interactions)
+{
+    uint64_t tuple_idx = 0;
+    row_interactions->reserve(row_interactions->size() + tuple_offsets.size());
+    build_row_interactions(row, row_interactions, 0, t, 0, &tuple_idx);
+}
+
+/* HELPER METHOD: build_row_interactions - recursive part of the above
+ * - top down recursive; walks the column tuples in exactly the order build_t_way_interactions() did, so the
+ *   running tuple_idx is the rank of the current tuple, while value_idx accumulates the mixed-radix digits
  * 
  * parameters:
  * - row: integer array representing a row up for consideration for appending to the array
- * - row_interactions: initially empty set to hold the Interactions as they are recovered
+ * - row_interactions: vector to hold the Interactions as they are recovered
  * - start: left side of row at which to begin the for loop
  * - t_cur: distance from right side of row at which to end the for loop
- * - key: auxiliary vector of pointers used to track the current combination of Singles
+ * - value_idx: mixed-radix index of the values chosen so far within the current column tuple
+ * - tuple_idx: running count of column tuples completed so far
  * 
  * returns:
- * - void, but after the method finishes, the row_interactions set will hold all the interactions in the row
+ * - void, but after the method finishes, row_interactions will hold all the interactions in the row
 */
-void Array::build_row_interactions(uint16_t *row, std::set<Interaction*> *row_interactions,
-    uint16_t start, uint16_t t_cur, std::string key)
+void Array::build_row_interactions(uint16_t *row, std::vector<Interaction*> *row_interactions,
+    uint16_t start, uint16_t t_cur, uint64_t value_idx, uint64_t *tuple_idx)
 {
     if (t_cur == 0) {
-        row_interactions->insert(interaction_map.at(key));
+        row_interactions->push_back(interactions[tuple_offsets[(*tuple_idx)++] + value_idx]);
         return;
     }
 
     uint16_t end = num_factors - t_cur + 1;
-    for (uint16_t col = start; col < end; col++) {
-        std::string cur = key + "f" + std::to_string(col) + "," + std::to_string(row[col]);
-        build_row_interactions(row, row_interactions, col+1, t_cur-1, cur);
+    for (uint16_t col = start; col < end; col++)
+        build_row_interactions(row, row_interactions, col+1, t_cur-1,
+            value_idx*factors[col]->level + row[col], tuple_idx);
+}
+
+/* UTILITY METHOD: build_column_interactions - gets the Interactions of a row that go through a given column
+ * - these are the only Interactions of the row that change when the value in that column does
+ * 
+ * parameters:
+ * - row: integer array representing a row up for consideration for appending to the array
+ * - col: the column
+ * - col_interactions: vector to which the Interactions are appended, C(num_factors-1, t-1) of them
+ * 
+ * returns:
+ * - void, but after the method finishes, col_interactions will hold the Interactions through the column
+*/
+void Array::build_column_interactions(uint16_t *row, uint16_t col,
+    std::vector<Interaction*> *col_interactions)
+{
+    uint16_t k = t - 1; // number of other columns to choose, from among the num_factors-1 other columns
+    std::vector<uint64_t> others(k);
+    std::vector<uint16_t> cols(t);
+    for (uint16_t j = 0; j < k; j++) others[j] = j;
+    while (true) {
+        // merge the chosen others (shifted past col) and col itself into increasing order
+        uint16_t m = 0;
+        bool placed = false;
+        for (uint16_t j = 0; j < k; j++) {
+            uint16_t other = static_cast<uint16_t>(others[j] >= col ? others[j] + 1 : others[j]);
+            if (!placed && col < other) {
+                cols[m++] = col;
+                placed = true;
+            }
+            cols[m++] = other;
+        }
+        if (!placed) cols[m] = col;
+
+        uint64_t value_idx = 0; // mixed-radix index of the row's values within the tuple
+        for (uint16_t c : cols) value_idx = value_idx*factors[c]->level + row[c];
+        col_interactions->push_back(interactions[tuple_offsets[tuple_rank(cols.data())] + value_idx]);
+        if (!next_colex(others.data(), k, num_factors - 1)) break;
     }
 }
 
+/* UTILITY METHOD: column_gains - counts how many uncovered Interactions each value of a column would complete
+ * - only Interactions whose other columns have all been placed are counted, so this works on a row that is
+ *   still being filled in; the column's own value in the row is never looked at
+ * - every Interaction through the column is a run of level flags in one of the uncovered_views, so all the
+ *   values are counted at once by the coverage kernel
+ * 
+ * parameters:
+ * - row: integer array representing a row, placed columns of which hold their values
+ * - col: the column
+ * - placed: per column, whether it has been placed yet; nullptr if all columns have
+ * - gains: pointer to where the counts should be stored, one for each value of the column
+ * 
+ * returns:
+ * - void, but after the method finishes, gains[v] will hold the count for value v
+*/
+void Array::column_gains(uint16_t *row, uint16_t col, bool *placed, uint32_t *gains)
+{
+    for (uint16_t val = 0; val < factors[col]->level; val++) gains[val] = 0;
+    std::vector<uint16_t> candidates;   // the other columns an Interaction through this one may use
+    for (uint16_t c = 0; c < num_factors; c++)
+        if (c != col && (placed == nullptr || placed[c])) candidates.push_back(c);
+    uint16_t k = t - 1;
+    if (candidates.size() < k) return;
+
+    std::vector<uint64_t> others(k), starts;
+    std::vector<uint16_t> cols(t);
+    for (uint16_t j = 0; j < k; j++) others[j] = j;
+    while (true) {
+        // merge the chosen others and col itself into increasing order, noting where col lands
+        uint16_t m = 0, pos = k;
+        for (uint16_t j = 0; j < k; j++) {
+            uint16_t other = candidates[others[j]];
+            if (pos == k && col < other) pos = m++; // leave a gap for col
+            cols[m++] = other;
+        }
+        cols[pos] = col;
+
+        uint64_t value_idx = 0; // index of the run within the tuple, in the view where col is least significant
+        for (uint16_t c : cols)
+            if (c != col) value_idx = value_idx*factors[c]->level + row[c];
+        starts.push_back(pos*interactions.size() + tuple_offsets[tuple_rank(cols.data())] +
+            value_idx*factors[col]->level);
+        if (!next_colex(others.data(), k, candidates.size())) break;
+    }
+    coverage_kernel.sum_runs(uncovered_views.data(), starts.data(), starts.size(), factors[col]->level, gains);
+}
+
 /* UTILITY METHOD: print_stats - outputs current state of the Array to console
  * - output details vary depending on what flags are set
  * 
@@ -387,9 +864,9 @@ void Array::print_stats(bool initial)
     if (v == v_on) {
         uint64_t c_score = coverage_problems, l_score = location_problems, d_score = detection_problems;
         for (Single *s : singles) {
-            c_score += s->c_issues;
-            l_score += s->l_issues;
-            d_score += s->d_issues;
+            c_score += c_issues[s->id];
+            l_score += l_issues[s->id];
+            d_score += d_issues[s->id];
         }
         printf("\t- Current coverage score: %lu\n", c_score);
         if (p != c_only) printf("\t- Current location score: %lu\n", l_score);
@@ -411,172 +888,624 @@ void Array::print_stats(bool initial)
  * 
  * parameters:
  * - row: integer array representing a row that should be added to the array
- * - keep: boolean representing whether or not the changes are intended to be kept
- *  --> true by default; when false, score changes are kept but the row itself is not added
+ *  --> the values are copied into the array, so the caller still owns the pointer
+ *  --> to see how scores would change without adding the row, use score_row() instead
  * 
  * returns:
  * - void, but after the method finishes, the array will have a new row appended to its end
+ *  --> the row is also written to the sink given to stream_rows(), if any
 */
-void Array::update_array(uint16_t *row, bool keep)
+void Array::update_array(uint16_t *row)
 {
-    rows.push_back(row);
-    if (o == normal && keep) {
-        printf("> Pushed row:\t");
-        for (uint16_t i = 0; i < num_factors; i++) printf("%hu\t", row[i]);
-        printf("\n");
+    rows.insert(rows.end(), row, row + num_factors);
+    if (sink) sink->write(row, num_factors);
+    if (o == normal) {  // built up first so the whole line goes out in one call
+        std::string line = "> Pushed row:\t";
+        RowSink::format(row, num_factors, &line);
+        fputs(line.c_str(), stdout);
     }
     num_tests++;
 
-    std::set<Interaction*> row_interactions;    // all Interactions that occur in this row
-    build_row_interactions(row, &row_interactions, 0, t, "");
-    std::set<T*> row_sets;  // all T sets that occur in this row
+    std::vector<Interaction*> row_interactions; // all Interactions that occur in this row
+    build_row_interactions(row, &row_interactions);
+    std::vector<uint64_t> row_sets; // ranks of all T sets that occur in this row
     for (Interaction *i : row_interactions) {
         for (Single *s: i->singles) s->rows.insert(num_tests); // add the row to Singles in this Interaction
         i->rows.insert(num_tests);          // add the row to this Interaction itself
-        for (T *t_set : i->sets) {
-            t_set->rows.insert(num_tests);  // add the row to all T sets this Interaction is part of
-            row_sets.insert(t_set);         // also add the T set to row_sets
-        }
+        if (p != c_only) sets_containing(i->rank, &row_sets);  // all T sets this Interaction is part of
     }
+    std::sort(row_sets.begin(), row_sets.end());    // sets with 2+ Interactions in the row show up repeatedly
+    row_sets.erase(std::unique(row_sets.begin(), row_sets.end()), row_sets.end());
     
+    bool was_locating = is_locating;
+    invalidate_cached_scores(&row_interactions, &row_sets); // needs to see the classes before they split
     update_scores(&row_interactions, &row_sets);
-    if (!keep) {
-        num_tests--;
-        rows.pop_back();
+    if (is_locating != was_locating && score_cache)  // location no longer counts towards any score
+        score_cache->invalidate_all();
+    update_dont_cares();
+    update_heuristic();
+}
+
+/* SUB METHOD: add_rows - adds many given rows at once, such as those of a partial array
+ * - leaves the array in exactly the state that adding the rows one at a time with add_row() would, but gets
+ *   there in far fewer passes: the rows are all laid down first, then coverage and detection are each worked
+ *   out in a single pass over the Interactions from the rows they ended up in; only the classes of T sets
+ *   are still split one row at a time, since their order depends on the order of the rows
+ * - the score each row would have left behind is worked out along the way, so that update_heuristic() can
+ *   still be called once per row, and pick the heuristic that the rows one at a time would have
+ *  --> only a new array is loaded this way; if it already has rows, they are added one at a time instead
+ * 
+ * parameters:
+ * - new_rows: pointer to the rows to add, one after another; the values are copied, so the caller still
+ *   owns them
+ * - count: how many rows there are
+ * 
+ * returns:
+ * - void, but after the method finishes, the array will have the rows appended to its end
+*/
+void Array::add_rows(uint16_t *new_rows, uint64_t count)
+{
+    if (num_tests != 0 || count < 2) {
+        for (uint64_t row = 0; row < count; row++) update_array(&new_rows[row*num_factors]);
         return;
     }
+
+    // lay down all the rows, noting which rows each Interaction occurs in as a plain table of bits, with
+    // rows numbered from 1 as update_array() does
+    uint64_t words = (count + 64)/64;
+    std::vector<uint64_t> occurs(interactions.size()*words, 0);
+    std::vector<Interaction*> row_interactions;
+    rows.reserve(count*num_factors);
+    for (uint16_t *row = new_rows; row < new_rows + count*num_factors; row += num_factors) {
+        rows.insert(rows.end(), row, row + num_factors);
+        if (sink) sink->write(row, num_factors);
+        num_tests++;
+        row_interactions.clear();
+        build_row_interactions(row, &row_interactions);
+        for (uint16_t col = 0; col < num_factors; col++) factors[col]->singles[row[col]].rows.insert(num_tests);
+        for (Interaction *i : row_interactions) {
+            i->rows.insert(num_tests);
+            occurs[i->rank*words + (num_tests >> 6)] |= static_cast<uint64_t>(1) << (num_tests & 63);
+        }
+    }
+    if (o == normal) printf("> Pushed %lu rows from the partial array.\n", count);
+
+    // how much each row takes off of the score through coverage and detection
+    std::vector<uint64_t> row_relief(count + 1, 0);
+    load_coverage(&row_relief);
+    if (p == all) load_detection(&occurs, words, &row_relief);
+    if (coverage_problems == 0) is_covering = true;
+    if (p == all && detection_problems == 0) is_detecting = true;
+
+    // location goes row by row as usual, other than the location issues of the Singles, which are totalled
+    // at the end; along the way, each row's score is what update_heuristic() would have seen
+    std::vector<uint64_t> row_sets;
+    std::vector<std::pair<uint64_t, uint64_t>> relief;
+    for (uint64_t row = 1; row <= count; row++) {
+        score -= row_relief[row];
+        if (p != c_only && !is_locating) {
+            row_interactions.clear();
+            build_row_interactions(&rows[(row - 1)*num_factors], &row_interactions);
+            row_sets.clear();
+            for (Interaction *i : row_interactions) sets_containing(i->rank, &row_sets);
+            std::sort(row_sets.begin(), row_sets.end());
+            row_sets.erase(std::unique(row_sets.begin(), row_sets.end()), row_sets.end());
+            relief.clear();
+            split_classes(&row_sets, &relief);
+            for (std::pair<uint64_t, uint64_t> &lost : relief) score -= lost.second*d*t;   // d*t Singles each
+        }
+        update_heuristic();
+    }
+    worst_heap_valid = false;
+    if (p != c_only) {
+        std::vector<uint64_t> totals;
+        location_totals(&totals);
+        for (uint16_t col = 0; col < num_factors; col++) factors[col]->l_issues = 0;
+        for (Single *s : singles) l_issues[s->id] = 0;
+        for (Interaction *i : interactions)
+            for (Single *s : i->singles) l_issues[s->id] += totals[i->rank];
+        for (Single *s : singles) factors[s->factor]->l_issues += l_issues[s->id];
+    }
     update_dont_cares();
-    if (heuristic_in_use != all) {
-        std::string row_str = std::to_string(row[0]);   // string representation of the row
-        for (uint16_t col = 1; col < num_factors; col++)
-            row_str += ' ' + std::to_string(row[col]);
-        row_scores[row_str] = delta <= 1 ? 1 : UINT64_MAX;  // will allow heuristic_all to skip some work
+}
+
+/* HELPER METHOD: load_coverage - covers every Interaction that occurs in the rows laid down by add_rows()
+ * 
+ * parameters:
+ * - row_relief: pointer to the amount each row takes off of the score, indexed by row number; each
+ *   Interaction's coverage is credited to the first row it occurs in
+ * 
+ * returns:
+ * - void, but after the method finishes, coverage will be up to date
+*/
+void Array::load_coverage(std::vector<uint64_t> *row_relief)
+{
+    for (Interaction *i : interactions) {
+        if (i->rows.empty()) continue;
+        is_covered[i->rank] = true;
+        mark_covered(i);
+        for (Single *s : i->singles) {
+            c_issues[s->id]--;
+            factors[s->factor]->c_issues--;
+        }
+        coverage_problems--;
+        (*row_relief)[*i->rows.begin()] += t + 1;   // one issue for each of its Singles, and the problem
     }
-    update_heuristic();
 }
 
-/* HELPER METHOD: update_scores - updates overall scores as well as for individual Singles, Interactions, Ts
+/* HELPER METHOD: load_detection - works out the separations left by the rows laid down by add_rows()
+ * - a T set not containing an Interaction gains one row of separation from it for every row the Interaction
+ *   occurs in and the T set does not, up to delta; so the rows that counted are the first delta such rows,
+ *   and the Interaction became detectable at the last row to count for any T set
+ * - the Interactions are split into chunks that run in parallel, much like build_separations()
  * 
  * parameters:
- * - row_interactions: set containing all Interactions present in the new row
- * - row_sets: set containing all T sets present in the new row
+ * - occurs: pointer to the table of bits of the rows each Interaction occurs in, words per Interaction
+ * - words: number of words per Interaction in occurs
+ * - row_relief: pointer to the amount each row takes off of the score, indexed by row number
  * 
  * returns:
+ * - void, but after the method finishes, detection will be up to date
+*/
+void Array::load_detection(std::vector<uint64_t> *occurs, uint64_t words, std::vector<uint64_t> *row_relief)
+{
+    uint64_t chunks = chunk_count(interactions.size());
+    uint64_t width = row_relief->size();
+    std::vector<uint64_t> d_relief(chunks*singles.size(), 0), rows_relief(chunks*width, 0), solved(chunks, 0);
+    run_chunks(interactions.size(), chunks, [this, occurs, words, width, &d_relief, &rows_relief, &solved](
+        uint64_t begin, uint64_t end, uint64_t chunk) {
+        uint64_t *relief = &rows_relief[chunk*width];
+        std::vector<uint64_t> members(d);
+        for (uint64_t i_rank = begin; i_rank < end; i_rank++) {
+            const uint64_t *mine = &(*occurs)[i_rank*words];
+            uint64_t last = 0;  // the row in which the Interaction becomes detectable, if it does
+            for (uint64_t word = 0; word < words && last == 0; word++)
+                if (mine[word] != 0) last = word*64 + static_cast<uint64_t>(__builtin_ctzll(mine[word]));
+            if (last == 0) continue;    // not in any row, so nothing changes
+
+            uint8_t *sep = &separations[i_rank*num_sets];
+            uint64_t gained = 0;    // rows of separation gained from all T sets together
+            for (uint16_t j = 0; j < d; j++) members[j] = j;
+            uint64_t rank = 0;
+            do {    // in order of rank
+                if (sep[rank] < delta) {
+                    uint64_t need = delta - sep[rank], got = 0, row = 0;
+                    for (uint64_t word = 0; word < words && got < need; word++) {
+                        uint64_t bits = mine[word];     // rows with the Interaction but not the T set
+                        for (uint64_t m : members) bits &= ~(*occurs)[m*words + word];
+                        for (; bits != 0 && got < need; bits &= bits - 1, got++) {
+                            row = word*64 + static_cast<uint64_t>(__builtin_ctzll(bits));
+                            relief[row] += t;   // one issue for each of the Interaction's Singles
+                        }
+                    }
+                    sep[rank] = static_cast<uint8_t>(sep[rank] + got);
+                    gained += got;
+                    if (got == need && row > last) last = row;
+                }
+                rank++;
+            } while (next_colex(members.data(), d, interactions.size()));
+
+            // blocks of T sets that no longer need separation drop out, as update_interactions() would do
+            uint64_t *active = &active_blocks[i_rank*active_words];
+            for (uint64_t word = 0; word < active_words; word++)
+                for (uint64_t bits = active[word]; bits != 0; bits &= bits - 1) {
+                    uint64_t block = word*64 + static_cast<uint64_t>(__builtin_ctzll(bits));
+                    bool saturated = true;
+                    for (uint64_t set = block*64; saturated && set < num_sets && set < (block + 1)*64; set++)
+                        if (sep[set] < delta) saturated = false;
+                    if (saturated) {
+                        active[word] &= ~(static_cast<uint64_t>(1) << (block & 63));
+                        active_block_count[i_rank]--;
+                    }
+                }
+            for (Single *s : interactions[i_rank]->singles) d_relief[chunk*singles.size() + s->id] += gained;
+            if (active_block_count[i_rank] == 0) {
+                is_detectable[i_rank] = true;
+                relief[last]++;
+                solved[chunk]++;
+            }
+        }
+    });
+
+    for (uint64_t chunk = 0; chunk < chunks; chunk++) {
+        for (Single *s : singles) {
+            uint64_t dr = d_relief[chunk*singles.size() + s->id];
+            factors[s->factor]->d_issues -= dr;
+            d_issues[s->id] -= dr;
+        }
+        detection_problems -= solved[chunk];
+        for (uint64_t row = 0; row < width; row++) (*row_relief)[row] += rows_relief[chunk*width + row];
+    }
+}
+
+/* HELPER METHOD: update_scores - updates overall scores as well as for individual Singles, Interactions, Ts
+ * - the Interactions in the row, and then the T sets whose location issues change, are split into chunks
+ *   that run in parallel; each chunk keeps its relief of the Singles' issues on the side, and those are
+ *   merged once all chunks are done, so the result is the same as if it had all been done in one thread
+ *
+ * parameters:
+ * - row_interactions: vector containing all Interactions present in the new row
+ * - row_sets: sorted vector containing the ranks of all T sets present in the new row
+ *
+ * returns:
  * - void, but after the method finishes, scores will be updated
  *  --> additionally, all Singles, Interactions, and Ts will have their data structures updated accordingly
 */
-void Array::update_scores(std::set<Interaction*> *row_interactions, std::set<T*> *row_sets)
+void Array::update_scores(std::vector<Interaction*> *row_interactions, std::vector<uint64_t> *row_sets)
 {
+    // mark the T sets in this row, since detection checks them for every Interaction
+    if (p == all)
+        for (uint64_t rank : *row_sets) row_set_bits[rank >> 6] |= static_cast<uint64_t>(1) << (rank & 63);
+
     // coverage and detection are associated with interactions
-    for (Interaction *i : *row_interactions) {
-        // coverage
-        if (!i->is_covered) {   // if true, this Interaction just became covered
-            i->is_covered = true;
-            for (Single *s: i->singles) {
-                factors[s->factor]->c_issues--;
-                s->c_issues--;
-                score--;
-            }
-            score--;    // array score improves for the solved coverage problem
-            if (--coverage_problems == 0) is_covering = true;
+    uint64_t chunks = chunk_count(row_interactions->size(), 64);
+    std::vector<uint64_t> c_relief(chunks*singles.size(), 0), d_relief(chunks*singles.size(), 0);
+    std::vector<uint64_t> solved(chunks*2, 0);  // per chunk, Interactions newly covered and newly detectable
+    std::vector<uint8_t> changed(singles.size(), 0);    // per Single, whether any of its issues went down
+    run_chunks(row_interactions->size(), chunks, [this, row_interactions, &c_relief, &d_relief, &solved](
+        uint64_t begin, uint64_t end, uint64_t chunk) {
+        update_interactions(row_interactions, begin, end, &c_relief[chunk*singles.size()],
+            &d_relief[chunk*singles.size()], &solved[chunk*2]);
+    });
+    for (uint64_t chunk = 0; chunk < chunks; chunk++) {
+        for (Single *s : singles) {
+            uint64_t c = c_relief[chunk*singles.size() + s->id], dr = d_relief[chunk*singles.size() + s->id];
+            factors[s->factor]->c_issues -= c;
+            c_issues[s->id] -= c;
+            factors[s->factor]->d_issues -= dr;
+            d_issues[s->id] -= dr;
+            score -= c + dr;
+            if (c + dr > 0) changed[s->id] = 1;
         }
+        score -= solved[chunk*2] + solved[chunk*2 + 1];   // array score improves for each solved problem
+        coverage_problems -= solved[chunk*2];
+        detection_problems -= solved[chunk*2 + 1];
+    }
+    if (coverage_problems == 0) is_covering = true;
+    if (p == all && detection_problems == 0) is_detecting = true;
 
-        // detection
-        if (p == all) { // the following is only done if we care about detection
-            if (i->is_detectable) continue; // can skip all this checking if already detectable
-            i->is_detectable = true;    // about to set it back to false if anything is unsatisfied still
-            // updating detection issues for this Interaction:
-            std::set<T*> other_sets = *row_sets;    // will hold all row T sets this Interaction is NOT in
-            for (T *t_set : i->sets) other_sets.erase(t_set);
-            for (T *t_set : other_sets) {   // for every T set in this row that this Interaction is not in,
-                if (i->deltas.at(t_set) <= delta)
-                    for (Single *s: i->singles) {
-                        factors[s->factor]->d_issues++;
-                        s->d_issues++;  // to balance out a -- later
-                        score++;
-                    }
-                i->deltas.at(t_set)--;  // to balance out all deltas getting ++ after this
-            }
-            for (auto &kv : i->deltas) {    // for all T sets,
-                kv.second++;    // increase their separation; offset by the -- earlier for T sets in this row
-                if (kv.second < delta) i->is_detectable = false;    // separation still not high enough
-                if (kv.second <= delta) // detection issue heading towards solved for all Singles involved
-                    for (Single *s: i->singles) {
-                        factors[s->factor]->d_issues--;
-                        s->d_issues--;
-                        score--;
-                    }
+    if (p == all)
+        for (uint64_t rank : *row_sets) row_set_bits[rank >> 6] = 0;    // unmark for the next row
+
+    // location is associated with sets of interactions
+    if (p != c_only && !is_locating) {  // the following is only done if we care about location
+        std::vector<std::pair<uint64_t, uint64_t>> relief; // (rank, amount) of every T set losing conflicts
+        split_classes(row_sets, &relief);
+
+        // then take the lost conflicts off of the location issues of the Singles in those sets
+        chunks = chunk_count(relief.size(), 256);
+        std::vector<uint64_t> l_relief(chunks*singles.size(), 0);
+        run_chunks(relief.size(), chunks, [this, &relief, &l_relief](uint64_t begin, uint64_t end,
+            uint64_t chunk) {
+            for (uint64_t idx = begin; idx < end; idx++)
+                relieve_location_issues(relief[idx].first, relief[idx].second, &l_relief[chunk*singles.size()]);
+        });
+        for (uint64_t chunk = 0; chunk < chunks; chunk++)
+            for (Single *s : singles) {
+                uint64_t l = l_relief[chunk*singles.size() + s->id];
+                factors[s->factor]->l_issues -= l;
+                l_issues[s->id] -= l;
+                score -= l;
+                if (l > 0) changed[s->id] = 1;
             }
-            if (i->is_detectable) { // if true, this Interaction just became detectable
-                score--;    // array score improves for the solved detection problem
-                if (--detection_problems == 0) is_detecting = true;
+    }
+
+    if (worst_heap_valid) update_worst_heap(row_interactions, &changed);
+}
+
+/* HELPER METHOD: split_classes - splits the classes of T sets by whether they occur in a new row
+ * - also keeps unseen_sets up to date, and calls solve_location_problem() for every T set that is left alone
+ *   in its class; the location issues of the Singles are not touched, but what they lose is listed instead
+ *
+ * parameters:
+ * - row_sets: sorted vector containing the ranks of all T sets present in the new row
+ * - relief: pointer to the vector to append (rank, amount) to, for every T set that loses amount conflicts
+ *
+ * returns:
+ * - void, but after the method finishes, the classes will be split
+*/
+void Array::split_classes(std::vector<uint64_t> *row_sets, std::vector<std::pair<uint64_t, uint64_t>> *relief)
+{
+    // first, move every T set in this row to the front of its class's range, counting how many moved
+    std::vector<uint64_t> touched;  // classes with at least one T set in this row
+    for (uint64_t rank : *row_sets) {
+        uint64_t c = set_class[rank];
+        if (class_split[c] == 0) touched.push_back(c);
+        uint64_t dest = class_start[c] + class_split[c]++;  // next slot not yet taken by a moved set
+        uint64_t displaced = set_order[dest];
+        set_order[set_position[rank]] = displaced;
+        set_position[displaced] = set_position[rank];
+        set_order[dest] = rank;
+        set_position[rank] = dest;
+    }
+
+    // then split each of those classes into the part that occurs in this row and the part that does not
+    std::vector<uint64_t> members(d);
+    for (uint64_t c : touched) {
+        uint64_t in_row = class_split[c], size = class_size[c];
+        class_split[c] = 0;
+        if (c != 0 && in_row == size) continue; // all the sets are still in the same rows as each other
+        uint64_t new_c = class_start.size();    // the part in this row becomes a new class
+        class_start.push_back(class_start[c]);
+        class_size.push_back(in_row);
+        class_split.push_back(0);
+        class_start[c] += in_row;
+        class_size[c] -= in_row;
+        for (uint64_t pos = class_start[new_c]; pos < class_start[c]; pos++) {
+            set_class[set_order[pos]] = new_c;
+            if (c == 0) {   // one less T set still unseen for each of its Interactions
+                unrank_set(set_order[pos], members.data());
+                for (uint64_t m : members) unseen_sets[m]--;
             }
+            // a set occurring for the first time had num_sets issues, and now conflicts only with the
+            // other sets occurring for the first time; otherwise, it just lost the conflicts left behind
+            relief->push_back({set_order[pos], c == 0 ? num_sets - (in_row - 1) : size - in_row});
         }
+        if (c != 0) // the sets left behind lost their conflicts with the ones in this row
+            for (uint64_t pos = class_start[c]; pos < class_start[c] + class_size[c]; pos++)
+                relief->push_back({set_order[pos], in_row});
+        if (in_row == 1) solve_location_problem();  // the set in this row just became locatable
+        if (c != 0 && size - in_row == 1) solve_location_problem(); // the set left behind did too
     }
+}
 
-    // location is associated with sets of interactions
-    if (p != c_only && !is_locating) {  // the following is only done if we care about location
-        for (T *t1 : *row_sets) {   // for every T set in this row,
-            if (t1->is_locatable) continue;
-            if (t1->rows.size() == 1) {   // if true, this is the first time the set has been added, so
-                for (Single *s : t1->singles) {
-                    factors[s->factor]->l_issues -= sets.size();
-                    s->l_issues -= sets.size();
-                    score -= sets.size();
-                }
-                t1->location_conflicts.clear();
-                for (T *t2 : *row_sets) {   // for every other T set in this row,
-                    if (t1 == t2 || t2->rows.size() > 1) continue;  // (skip when either of these is true)
-                    t1->location_conflicts.insert(t2);  // can assume there is a location conflict
-                    for (Single *s: t1->singles) {  // scores actually worsen here
-                        factors[s->factor]->l_issues++;
-                        s->l_issues++;
-                        score++;
-                    }
-                }
-            } else {    // need to check if location issues were solved
-                std::set<T*> temp = t1->location_conflicts; // make a shallow copy (for mutating), and
-                uint64_t solved = 0;
-                std::set<T*> others;
-                for (T *t2 : t1->location_conflicts)    // for every T set in the current T's conflicts,
-                    if (row_sets->find(t2) == row_sets->end()) {    // if that set is not in this row,
-                        temp.erase(t2); // it is no longer an issue for the current T
-                        solved++;
-                        if (t2->location_conflicts.erase(t1) == 1) {    // vice versa:
-                            for (Single *s : t2->singles) { // conflicting T also had a location issue solved
-                                factors[s->factor]->l_issues--;
-                                s->l_issues--;
-                                score--;
-                            }
-                            if (t2->location_conflicts.size() == 0) {   // if true,
-                                t2->is_locatable = true;    // conflicting T just became locatable
-                                score--;    // array score improves for the solved location problem
-                                location_problems--;
-                                if (location_problems == 0) {
-                                    printf("ERROR: Unexpected behavior here, rerun in debug mode\n");
-                                    exit(-1);
-                                }
-                            }
-                        } else {
-                            printf("ERROR: Unexpected behavior here, rerun in debug mode\n");
-                            exit(-1);
+/* HELPER METHOD: update_interactions - updates coverage and detection for a chunk of a new row's Interactions
+ * - safe to run on different chunks at the same time, since each Interaction only updates its own state
+ *   and the relief of the Singles' issues is kept on the side; see update_scores()
+ *
+ * parameters:
+ * - row_interactions: vector containing all Interactions present in the new row
+ * - begin: index into row_interactions of the first Interaction in the chunk
+ * - end: index into row_interactions just past the last Interaction in the chunk
+ * - c_relief: per Single (indexed by id), how much its coverage issues should go down
+ * - d_relief: per Single (indexed by id), how much its detection issues should go down
+ * - solved: how many Interactions just became covered, followed by how many just became detectable
+ *
+ * returns:
+ * - void, but after the method finishes, the Interactions will be updated, and their relief tallied
+*/
+void Array::update_interactions(std::vector<Interaction*> *row_interactions, uint64_t begin, uint64_t end,
+    uint64_t *c_relief, uint64_t *d_relief, uint64_t *solved)
+{
+    for (uint64_t idx = begin; idx < end; idx++) {
+        Interaction *i = row_interactions->at(idx);
+
+        // coverage
+        if (!is_covered[i->rank]) { // if true, this Interaction just became covered
+            is_covered[i->rank] = true;
+            mark_covered(i);
+            for (Single *s: i->singles) c_relief[s->id]++;
+            solved[0]++;
+        }
+
+        // detection
+        if (p == all) { // the following is only done if we care about detection
+            if (is_detectable[i->rank]) continue;   // can skip all this checking if already detectable
+            // only blocks of T sets from which separation is still insufficient need to be visited; a T set
+            // not in this row gains one more row of separation, while one in this row stays the same
+            uint8_t *sep = &separations[i->rank*num_sets];
+            uint64_t *active = &active_blocks[i->rank*active_words];
+            for (uint64_t word = 0; word < active_words; word++)
+                for (uint64_t bits = active[word]; bits != 0; bits &= bits - 1) {
+                    uint64_t block = word*64 + static_cast<uint64_t>(__builtin_ctzll(bits));
+                    uint64_t in_row = row_set_bits[block], block_solved = 0;
+                    bool saturated = true;
+                    for (uint64_t rank = block*64; rank < num_sets && rank < (block + 1)*64; rank++) {
+                        if (sep[rank] >= delta) continue;   // (skip if separation is already sufficient)
+                        if (!((in_row >> (rank & 63)) & 1)) {
+                            sep[rank]++;    // detection issue heading towards solved for all Singles involved
+                            block_solved++;
                         }
+                        if (sep[rank] < delta) saturated = false;
+                    }
+                    for (Single *s: i->singles) d_relief[s->id] += block_solved;
+                    if (saturated) {    // this whole block no longer needs to be visited
+                        active[word] &= ~(static_cast<uint64_t>(1) << (block & 63));
+                        active_block_count[i->rank]--;
                     }
-                for (Single *s: t1->singles) {  // update scores
-                    factors[s->factor]->l_issues -= solved;
-                    s->l_issues -= solved;
-                    score -= solved;
                 }
-                t1->location_conflicts = temp;  // mutating completed, can update original now
+            is_detectable[i->rank] = active_block_count[i->rank] == 0;
+            if (is_detectable[i->rank]) solved[1]++;    // this Interaction just became detectable
+        }
+    }
+}
+
+/* HELPER METHOD: invalidate_cached_scores - marks stale every cached heuristic_all score a new row will change
+ * - should be called just before update_scores(), while the classes of T sets are still as they were
+ * - a candidate row's score only depends on the state of its own Interactions (coverage and detection) and
+ *   on the classes of the T sets containing them (location); so the candidates affected are the ones that
+ *   share an Interaction with the new row, or with a T set of any class the new row splits
+ *  --> class 0 has nearly every T set in it for as long as it is being split, so that marks everything
+ * 
+ * parameters:
+ * - row_interactions: vector containing all Interactions present in the new row
+ * - row_sets: sorted vector containing the ranks of all T sets present in the new row
+ * 
+ * returns:
+ * - void, but after the method finishes, every affected score in score_cache will be marked stale
+*/
+void Array::invalidate_cached_scores(std::vector<Interaction*> *row_interactions,
+    std::vector<uint64_t> *row_sets)
+{
+    if (!score_cache || score_cache->empty()) return;   // heuristic_all has not cached anything yet
+    std::vector<uint8_t> dirty(interactions.size(), 0); // Interactions whose dependents need rescoring
+    for (Interaction *i : *row_interactions) dirty[i->rank] = 1;
+
+    if (p != c_only && !is_locating) {
+        std::vector<std::pair<uint64_t, uint64_t>> touched; // (class, rank) of every T set in the new row
+        for (uint64_t rank : *row_sets) touched.push_back({set_class[rank], rank});
+        std::sort(touched.begin(), touched.end());
+        std::vector<uint64_t> members(d);
+        for (uint64_t start = 0, end = 0; start < touched.size(); start = end) {
+            uint64_t c = touched[start].first;
+            while (end < touched.size() && touched[end].first == c) end++;
+            if (c == 0) {
+                score_cache->invalidate_all();
+                return;
             }
-            if (t1->location_conflicts.size() == 0) {   // if true,
-                t1->is_locatable = true;    // this T just became locatable
-                score--;    // array score improves for the solved location problem
-                location_problems--;
-                if (location_problems == 0) is_locating = true;
+            if (end - start == class_size[c]) continue; // the class will not split
+            for (uint64_t pos = class_start[c]; pos < class_start[c] + class_size[c]; pos++) {
+                unrank_set(set_order[pos], members.data());
+                for (uint64_t m : members) dirty[m] = 1;
             }
         }
     }
+
+    for (uint64_t rank = 0; rank < interactions.size(); rank++)
+        if (dirty[rank]) score_cache->invalidate(rank);
+}
+
+/* HELPER METHOD: update_worst_heap - brings the keys in worst_heap up to date after a new row
+ * - the key of an Interaction only changes if it is in the new row, or if the issues of one of its Singles
+ *   changed; when the latter are numerous enough that updating them one at a time would cost more than
+ *   building the heap again, the heap is just marked to be built again the next time it is needed
+ *
+ * parameters:
+ * - row_interactions: vector containing all Interactions present in the new row
+ * - changed: per Single (indexed by id), whether its issues changed
+ *
+ * returns:
+ * - void, but after the method finishes, worst_heap will be up to date or marked as not valid
+*/
+void Array::update_worst_heap(std::vector<Interaction*> *row_interactions, std::vector<uint8_t> *changed)
+{
+    uint64_t num_changed = 0;
+    for (uint8_t flag : *changed) num_changed += flag;
+    if (num_changed*t*4 > singles.size()) { // would touch over a quarter of the Interactions, on average
+        worst_heap_valid = false;
+        return;
+    }
+    for (Interaction *i : *row_interactions) worst_heap.update(i->rank, worst_key(i));
+    std::vector<uint64_t> ranks;
+    for (Single *s : singles) {
+        if (!(*changed)[s->id]) continue;
+        ranks.clear();
+        interactions_containing(s, &ranks);
+        for (uint64_t rank : ranks) worst_heap.update(rank, worst_key(interactions[rank]));
+    }
+}
+
+/* HELPER METHOD: mark_covered - clears an Interaction's flag in every one of the uncovered_views
+ * - safe to call for different Interactions at the same time, since no two share a flag in any view
+ *
+ * parameters:
+ * - i: the Interaction that just became covered
+*/
+void Array::mark_covered(Interaction *i)
+{
+    uint64_t value_idx = 0; // mixed-radix index of the Interaction within its tuple, in the usual order
+    for (Single *s : i->singles) value_idx = value_idx*factors[s->factor]->level + s->value;
+    uint64_t tuple_start = i->rank - value_idx;
+    for (uint16_t j = 0; j < t; j++) {
+        uint64_t view_idx = 0;  // the same, but with the j-th column's value moved to the end
+        for (uint16_t m = 0; m < t; m++)
+            if (m != j) view_idx = view_idx*factors[i->singles[m]->factor]->level + i->singles[m]->value;
+        view_idx = view_idx*factors[i->singles[j]->factor]->level + i->singles[j]->value;
+        uncovered_views[j*interactions.size() + tuple_start + view_idx] = 0;
+    }
+}
+
+/* HELPER METHOD: relieve_location_issues - tallies the location issues lost by every Single in a T set
+ * - safe to run in parallel with itself, as long as each thread has its own relief to add to
+ *
+ * parameters:
+ * - rank: rank of the T set
+ * - amount: how many location issues to take away from each Single (once per Interaction it appears in)
+ * - relief: per Single (indexed by id), how much its location issues should go down
+ *
+ * returns:
+ * - void, but after the method finishes, amount will be added to relief for every Single in the T set
+*/
+void Array::relieve_location_issues(uint64_t rank, uint64_t amount, uint64_t *relief) const
+{
+    std::vector<uint64_t> members(d);
+    unrank_set(rank, members.data());
+    for (uint64_t m : members)
+        for (Single *s : interactions[m]->singles) relief[s->id] += amount;
+}
+
+/* HELPER METHOD: solve_location_problem - accounts for a T set that just became locatable
+ *
+ * returns:
+ * - void, but after the method finishes, scores will be updated
+*/
+void Array::solve_location_problem()
+{
+    score--;    // array score improves for the solved location problem
+    if (--location_problems == 0) is_locating = true;
+}
+
+/* UTILITY METHOD: separation - gets how many rows separate an Interaction from a T set, up to delta
+ *
+ * parameters:
+ * - i: the Interaction
+ * - rank: rank of the T set
+ *
+ * returns:
+ * - the number of rows in which i occurs but the T set does not, or delta if that is at least delta
+*/
+uint16_t Array::separation(Interaction *i, uint64_t rank) const
+{
+    return separations[i->rank*num_sets + rank];
+}
+
+/* UTILITY METHOD: unseparated_sets - finds every T set from which an Interaction needs more separation
+ *
+ * parameters:
+ * - i: the Interaction
+ * - ranks: vector onto the end of which the ranks will be appended, in increasing order
+ *
+ * returns:
+ * - void, but after the method finishes, ranks will have the new entries
+*/
+void Array::unseparated_sets(Interaction *i, std::vector<uint64_t> *ranks) const
+{
+    const uint8_t *sep = &separations[i->rank*num_sets];
+    const uint64_t *active = &active_blocks[i->rank*active_words];
+    for (uint64_t word = 0; word < active_words; word++)
+        for (uint64_t bits = active[word]; bits != 0; bits &= bits - 1) {
+            uint64_t block = word*64 + static_cast<uint64_t>(__builtin_ctzll(bits));
+            for (uint64_t rank = block*64; rank < num_sets && rank < (block + 1)*64; rank++)
+                if (sep[rank] < delta) ranks->push_back(rank);
+        }
+}
+
+/* UTILITY METHOD: location_conflicts - counts the T sets that occur in exactly the same rows as a given one
+ *
+ * parameters:
+ * - rank: rank of the T set
+ *
+ * returns:
+ * - the number of location conflicts; a T set that has not occurred yet conflicts with every other T set
+*/
+uint64_t Array::location_conflicts(uint64_t rank) const
+{
+    uint64_t c = set_class[rank];
+    return c == 0 ? num_sets - 1 : class_size[c] - 1;
+}
+
+/* UTILITY METHOD: location_totals - sums, per Interaction, the location issues of the T sets containing it
+ * - this is what the Interaction contributes to the location issues of each of its Singles; a T set that
+ *   has not occurred yet counts num_sets, and any other counts its conflicts
+ *
+ * parameters:
+ * - totals: vector which will be resized to hold one total per Interaction, indexed by rank
+ *
+ * returns:
+ * - void, but after the method finishes, totals will be filled in
+*/
+void Array::location_totals(std::vector<uint64_t> *totals) const
+{
+    totals->assign(interactions.size(), 0);
+    if (d == 0 || interactions.size() < d) return;
+    std::vector<uint64_t> members(d);
+    for (uint16_t j = 0; j < d; j++) members[j] = j;
+    uint64_t rank = 0;
+    do {    // in order of rank
+        uint64_t c = set_class[rank++];
+        uint64_t issues = c == 0 ? num_sets : class_size[c] - 1;
+        for (uint64_t m : members) (*totals)[m] += issues;
+    } while (next_colex(members.data(), d, interactions.size()));
 }
 
 /* HELPER METHOD: update_dont_cares - updates column-total information to track don't care states
@@ -614,7 +1543,6 @@ void Array::update_dont_cares()
 */
 void Array::update_heuristic()
 {
-    just_switched_heuristics = true;    // assume true until determined to be false
     float ratio = static_cast<float>(score)/total_problems;
 
     // first up, should we use the most in-depth scoring function:
@@ -627,7 +1555,6 @@ void Array::update_heuristic()
             heuristic_in_use = d_only;  // small misnomer
         else if (heuristic_in_use == none)
             heuristic_in_use = c_only;
-        else just_switched_heuristics = false;
         return;
     }
     
@@ -642,7 +1569,6 @@ void Array::update_heuristic()
             heuristic_in_use = l_only;
         else if (heuristic_in_use == none)
             heuristic_in_use = c_only;
-        else just_switched_heuristics = false;
         return;
     }
 
@@ -659,55 +1585,83 @@ void Array::update_heuristic()
             heuristic_in_use = l_only;
         else if (heuristic_in_use == none)
             heuristic_in_use = c_only;
-        else just_switched_heuristics = false;
         return;
     }
 }
 
-Array *Array::clone()
+/* UTILITY METHOD: start_pool - starts the workers that chunks of work are run on
+ * - the workers are started only once, the first time this is called, and then kept for the Array's lifetime
+ * 
+ * returns:
+ * - bool representing whether the workers are running, which fails only when the system is out of resources
+*/
+bool Array::start_pool()
 {
-    // instantiate with private fields, copy public fields manually
-    Array *clone;
+    if (pool) return true;
+    uint32_t num_workers = max_threads == 0 ? 1 : max_threads;
     try {
-        clone = new Array(total_problems, coverage_problems, location_problems, detection_problems,
-            &rows, num_tests, num_factors, factors, p, d, t, delta);
-    } catch (const std::bad_alloc &e) { // when there isn't enough memory to create a clone
-        return nullptr;
-    }
-    clone->score = score;
-    clone->is_covering = is_covering;
-    clone->is_locating = is_locating;
-    clone->is_detecting = is_detecting;
-
-    // brand new Singles, Interactions, and Ts had to be allocated, so deep copying of data needed
-    for (Single *this_s : singles) {
-        Single *clone_s = clone->single_map.at(this_s->to_string());
-        clone_s->rows = this_s->rows;
-        clone_s->c_issues = this_s->c_issues;
-        clone_s->l_issues = this_s->l_issues;
-        clone_s->d_issues = this_s->d_issues;
-    }
-    for (Interaction *this_i : interactions) {
-        Interaction *clone_i = clone->interaction_map.at(this_i->to_string());
-        clone_i->rows = this_i->rows;
-        clone_i->is_covered = this_i->is_covered;
-        clone_i->is_detectable = this_i->is_detectable;
-        for (auto &kv : this_i->deltas) {
-            T *clone_t = clone->t_set_map.at(kv.first->to_string());
-            clone_i->deltas.insert({clone_t, kv.second});
-        }
-    }   // it hurts my brain so much to try and understand what's happening here lol
-    for (T *this_t : sets) {
-        T *clone_t = clone->t_set_map.at(this_t->to_string());
-        clone_t->rows = this_t->rows;
-        clone_t->is_locatable = this_t->is_locatable;
-        for (T *other_t : this_t->location_conflicts) {
-            T *clone_other_t = clone->t_set_map.at(other_t->to_string());
-            clone_t->location_conflicts.insert(clone_other_t);
-        }
-    }
-
-    return clone;
+        pool = new ThreadPool(num_workers, static_cast<uint64_t>(num_workers)*4);   // a few tasks each to spare
+    } catch (std::exception &e) {   // std::bad_alloc, or std::system_error if a thread could not be started
+        pool = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/* UTILITY METHOD: chunk_count - decides how many chunks run_chunks() should split some work into
+ * - a few per worker, so that uneven chunks even out, but never so many that a chunk has fewer than grain
+ *   items; with only one worker, there is nothing to gain from splitting the work at all
+ * 
+ * parameters:
+ * - n: number of items of work
+ * - grain: least number of items worth handing to a worker at once
+ * 
+ * returns:
+ * - number of chunks, which is at least 1
+*/
+uint64_t Array::chunk_count(uint64_t n, uint64_t grain) const
+{
+    uint64_t chunks = pool && pool->size() > 1 ? static_cast<uint64_t>(pool->size())*4 : 1;
+    if (chunks > n/grain) chunks = n/grain;
+    return chunks == 0 ? 1 : chunks;
+}
+
+/* UTILITY METHOD: run_chunks - splits items [0, n) into consecutive chunks and runs a task on each
+ * - the chunks run on the pool when it is running, or else one after another in this thread; either way,
+ *   this returns only once every chunk is done
+ * - which items make up each chunk depends only on n and chunks, so results kept per chunk and merged in
+ *   chunk order come out the same no matter how many threads ran them
+ * 
+ * parameters:
+ * - n: number of items of work
+ * - chunks: number of chunks to split them into; see chunk_count()
+ * - task: work to run on the items [begin, end) making up the chunk with the given index
+ * 
+ * returns:
+ * - void, but after the method finishes, task will have been run on every chunk
+ *  --> throws std::bad_alloc if any chunk ran out of memory
+*/
+void Array::run_chunks(uint64_t n, uint64_t chunks,
+    const std::function<void(uint64_t begin, uint64_t end, uint64_t chunk)> &task)
+{
+    std::atomic<bool> failed(false);
+    for (uint64_t chunk = 0; chunk < chunks; chunk++) {
+        uint64_t begin = n/chunks*chunk + std::min(chunk, n%chunks);   // the first n%chunks get 1 extra
+        uint64_t end = n/chunks*(chunk + 1) + std::min(chunk + 1, n%chunks);
+        if (!pool || chunks == 1) { // nothing would run alongside it, so skip the handoff
+            task(begin, end, chunk);
+            continue;
+        }
+        pool->submit([&task, &failed, begin, end, chunk]() {
+            try {
+                task(begin, end, chunk);
+            } catch (const std::bad_alloc &e) { // the pool's tasks must not throw, so pass it on after waiting
+                failed = true;
+            }
+        });
+    }
+    if (pool && chunks > 1) pool->wait();
+    if (failed) throw std::bad_alloc();
 }
 
 /* UTILITY METHOD: report_out_of_memory - prints an error message and sets out_of_memory to true
@@ -726,37 +1680,109 @@ void Array::report_out_of_memory()
     out_of_memory = true;
 }
 
-/* UTILITY METHOD: to_string - gets a string representation of the array
+/* UTILITY METHOD: write_rows - writes every row the array has so far to a sink
+ * 
+ * parameters:
+ * - row_sink: the sink to write to, which should be open
  * 
  * returns:
- * - a string representing the array
+ * - void, but after the method finishes, the sink will have been given all rows, in order
 */
-std::string Array::to_string()
+void Array::write_rows(RowSink *row_sink)
 {
-    std::string ret = "";
-    for (uint16_t *row : rows) {
-        for (uint16_t i = 0; i < num_factors; i++)
-            ret += std::to_string(row[i]) + '\t';
-        ret += '\n';
-    }
-    return ret;
+    for (uint64_t row = 0; row < num_tests; row++) row_sink->write(&rows[row*num_factors], num_factors);
+}
+
+/* UTILITY METHOD: stream_rows - writes every row the array has so far to a sink, then keeps writing to it
+ * - every row added from then on is written to the sink as soon as update_array() keeps it
+ * 
+ * parameters:
+ * - row_sink: the sink to write to, which should be open and outlive the array; nullptr stops streaming
+ * 
+ * returns:
+ * - void, but after the method finishes, the sink will have been given all rows so far
+*/
+void Array::stream_rows(RowSink *row_sink)
+{
+    sink = row_sink;
+    if (sink) write_rows(sink);
 }
 
 /* DECONSTRUCTOR - frees memory
+ * - Singles, Interactions, and rows live in arenas that are released all at once with the Array itself
 */
 Array::~Array()
 {
-    for (uint64_t i = 0; i < num_tests; i++) delete[] rows[i];
-    for (uint16_t i = 0; i < num_factors; i++) delete factors[i];
+    delete pool;    // stops the workers before anything they could be scoring against is gone
+    delete score_cache;
+    if (factors) for (uint16_t i = 0; i < num_factors; i++) delete factors[i];
     delete[] factors;
-    for (Interaction *i : interactions) delete i;
-    for (T *t_set : sets) delete t_set;
     delete[] dont_cares;
     delete[] permutation;
 }
 
 // ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
 
+/* HELPER METHOD: next_colex - advances a k-subset of [0, n) to the next one in colexicographic order
+ * - the first subset in that order is {0, 1, ..., k-1}, which has rank 0 (see Array::rank_set())
+ * 
+ * parameters:
+ * - members: pointer to the k members of the subset, in increasing order
+ * - k: size of the subset
+ * - n: size of the pool the subset is chosen from
+ * 
+ * returns:
+ * - false if the subset was already the last one, true otherwise (in which case it is modified)
+*/
+static bool next_colex(uint64_t *members, uint16_t k, uint64_t n)
+{
+    for (uint16_t j = 0; j < k; j++) {
+        uint64_t limit = j + 1 < k ? members[j + 1] : n;
+        if (members[j] + 1 < limit) {   // lowest member that can move up without colliding
+            members[j]++;
+            for (uint16_t l = 0; l < j; l++) members[l] = l;
+            return true;
+        }
+    }
+    return false;
+}
+
+/* HELPER METHOD: saturating_add - adds two counts, giving UINT64_MAX instead of overflowing
+*/
+static uint64_t saturating_add(uint64_t a, uint64_t b)
+{
+    return a > UINT64_MAX - b ? UINT64_MAX : a + b;
+}
+
+/* HELPER METHOD: saturating_mul - multiplies two counts, giving UINT64_MAX instead of overflowing
+*/
+static uint64_t saturating_mul(uint64_t a, uint64_t b)
+{
+    return b != 0 && a > UINT64_MAX/b ? UINT64_MAX : a*b;
+}
+
+/* HELPER METHOD: saturating_choose - gets the binomial coefficient C(n, k), or UINT64_MAX if it is too big
+ * - for when the tables of binomial coefficients have not been built yet
+*/
+static uint64_t saturating_choose(uint64_t n, uint64_t k)
+{
+    if (k > n) return 0;
+    if (k > n - k) k = n - k;
+    uint64_t c = 1;
+    for (uint64_t i = 0; i < k; i++) {  // C(n, i+1) = C(n, i)*(n-i)/(i+1), which always divides evenly
+        if (c > UINT64_MAX/(n - i)) return UINT64_MAX;
+        c = c*(n - i)/(i + 1);
+    }
+    return c;
+}
+
+/* HELPER METHOD: to_mib - converts a number of bytes to MiB, for printing
+*/
+static double to_mib(uint64_t bytes)
+{
+    return static_cast<double>(bytes)/(1 << 20);
+}
+
 static void print_singles(Factor **factors, uint16_t num_factors)
 {
     uint32_t pid = getpid();
@@ -764,8 +1790,8 @@ static void print_singles(Factor **factors, uint16_t num_factors)
     for (uint16_t col = 0; col < num_factors; col++) {
         printf("Factor %hu:\n", factors[col]->id);
         for (uint16_t level = 0; level < factors[col]->level; level++) {
-            printf("\t(f%hu, %hu): {", col, factors[col]->singles[level]->value);
-            for (uint64_t row : factors[col]->singles[level]->rows) printf(" %lu", row);
+            printf("\t(f%hu, %hu): {", col, factors[col]->singles[level].value);
+            for (uint64_t row : factors[col]->singles[level].rows) printf(" %lu", row);
             printf(" }\n");
         }
         printf("\n");
@@ -787,17 +1813,23 @@ static void print_interactions(std::vector<Interaction*> interactions)
     }
 }
 
-static void print_sets(std::vector<T*> sets)
+static void print_sets(std::vector<Interaction*> interactions, uint16_t d)
 {
     uint32_t pid = getpid();
     printf("\n==%d== Listing all Ts below:\n\n", pid);
+    if (interactions.size() < d) return;
+    std::vector<uint64_t> members(d);
+    for (uint16_t j = 0; j < d; j++) members[j] = j;
     uint32_t i = 0;
-    for (T *t_set : sets) {
-        t_set->id = ++i;
-        printf("Set %u:\n\tSet: {", i);
-        for (Interaction *interaction : t_set->interactions) printf(" %u", interaction->id);
+    do {    // in order of rank
+        printf("Set %u:\n\tSet: {", ++i);
+        RowSet rows;    // the union of the members' rows
+        for (uint64_t m : members) {
+            printf(" %u", interactions[m]->id);
+            rows.unite(interactions[m]->rows);
+        }
         printf(" }\n\tRows: {");
-        for (uint64_t row : t_set->rows) printf(" %lu", row);
+        for (uint64_t row : rows) printf(" %lu", row);
         printf(" }\n\n");
-    }
-}
\ No newline at end of file
+    } while (next_colex(members.data(), d, interactions.size()));
+}
@@ -0,0 +1,184 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the ScoreCache class declared in cache.h. Every |
+| public method takes the cache's own lock, so the Array's scoring threads may store into it while the main |
+| thread looks things up. Entries are never moved once stored, which is what lets the inverted index refer  |
+| to them by position; an entry is only ever overwritten in place when it is evicted.                      |
+|===========================================================================================================|
+*/
+
+#include "cache.h"
+
+const uint64_t ScoreCache::NO_KEY;
+const uint64_t ScoreCache::PROBES;
+
+/* CONSTRUCTOR - initializes the object
+ * - sizes the table once, to the largest power of 2 number of entries whose memory fits under max_bytes;
+ *   each entry is charged for its own fields, plus twice its share of the inverted index to leave room for
+ *   stale pairs that have not been dropped yet
+ *
+ * parameters:
+ * - max_bytes: memory cap for the table and its inverted index; at least 16 entries are always allowed
+ * - num_tags: number of distinct tags, which must be in the range [0, num_tags)
+ * - tags_per_key_o: how many tags each stored key depends on
+*/
+ScoreCache::ScoreCache(uint64_t max_bytes, uint64_t num_tags, uint64_t tags_per_key_o) :
+    tags_per_key(tags_per_key_o)
+{
+    uint64_t entry_bytes = 2*sizeof(uint64_t) + sizeof(uint8_t) + 2*sizeof(uint32_t) +
+        2*tags_per_key*sizeof(std::pair<uint32_t, uint32_t>);
+    uint64_t capacity = 16;
+    while (capacity < (static_cast<uint64_t>(1) << 31) && 2*capacity*entry_bytes <= max_bytes) capacity *= 2;
+    mask = capacity - 1;
+    keys.assign(capacity, NO_KEY);
+    scores.assign(capacity, 0);
+    fresh.assign(capacity, 0);
+    generation.assign(capacity, 0);
+    last_used.assign(capacity, 0);
+    dependents.resize(num_tags);
+}
+
+/* UTILITY METHOD: lookup - gets the cached score of a key, if it has one that still holds
+ *
+ * parameters:
+ * - key: the key to look up
+ * - score: pointer to where the score should be stored, if found
+ *
+ * returns:
+ * - true if the key was found with a fresh score, false otherwise
+*/
+bool ScoreCache::lookup(uint64_t key, uint64_t *score)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    for (uint64_t probe = 0; probe < PROBES; probe++) {
+        uint64_t entry = (home(key) + probe) & mask;
+        if (keys[entry] == NO_KEY) return false;    // entries are never emptied, so the key is not further on
+        if (keys[entry] != key) continue;
+        last_used[entry] = clock;
+        if (!fresh[entry]) return false;
+        *score = scores[entry];
+        return true;
+    }
+    return false;
+}
+
+/* UTILITY METHOD: store - caches the score of a key, evicting another key if there is no room for it
+ *
+ * parameters:
+ * - key: the key to store; must not be UINT64_MAX
+ * - score: the key's score
+ * - tags: the tags the score depends on; these should always be the same for a given key
+ *
+ * returns:
+ * - void, but after the method finishes, the key will have a fresh score in the table
+*/
+void ScoreCache::store(uint64_t key, uint64_t score, const std::vector<uint64_t> &tags)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    used = true;
+    uint64_t victim = home(key);
+    for (uint64_t probe = 0; probe < PROBES; probe++) {
+        uint64_t entry = (home(key) + probe) & mask;
+        if (keys[entry] == key) {   // already there (only stale, or a lookup would have found it)
+            scores[entry] = score;
+            fresh[entry] = 1;
+            last_used[entry] = clock;
+            return;
+        }
+        if (keys[entry] == NO_KEY) {    // nothing further on, and nothing better to take than this
+            victim = entry;
+            break;
+        }
+        if (fresh[victim] && !fresh[entry]) victim = entry;
+        else if (fresh[victim] == fresh[entry] && clock - last_used[entry] > clock - last_used[victim])
+            victim = entry;
+    }
+
+    keys[victim] = key;
+    scores[victim] = score;
+    fresh[victim] = 1;
+    generation[victim]++;   // any pairs in dependents left over from the evicted key are now stale
+    last_used[victim] = clock;
+    for (uint64_t tag : tags) dependents[tag].push_back({static_cast<uint32_t>(victim), generation[victim]});
+    dependent_count += tags.size();
+    if (dependent_count > 2*(mask + 1)*tags_per_key) compact_dependents();
+}
+
+/* UTILITY METHOD: invalidate - marks stale the score of every entry that depends on a tag
+ * - also drops the tag's stale pairs while passing over them
+ *
+ * parameters:
+ * - tag: the tag that changed
+*/
+void ScoreCache::invalidate(uint64_t tag)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    std::vector<std::pair<uint32_t, uint32_t>> &list = dependents[tag];
+    uint64_t kept = 0;
+    for (uint64_t idx = 0; idx < list.size(); idx++) {
+        if (generation[list[idx].first] != list[idx].second) continue;
+        fresh[list[idx].first] = 0;
+        list[kept++] = list[idx];
+    }
+    dependent_count -= list.size() - kept;
+    list.resize(kept);
+}
+
+/* UTILITY METHOD: invalidate_all - marks stale the score of every entry
+*/
+void ScoreCache::invalidate_all()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    for (uint8_t &entry : fresh) entry = 0;
+}
+
+/* UTILITY METHOD: tick - starts a new round of lookups
+ * - an entry not looked up or stored for the most rounds is the first to be evicted among fresh ones
+*/
+void ScoreCache::tick()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    clock++;
+}
+
+/* UTILITY METHOD: empty - checks whether anything has ever been stored
+*/
+bool ScoreCache::empty() const
+{
+    return !used;
+}
+
+/* UTILITY METHOD: capacity - gets the number of entries the table can hold
+*/
+uint64_t ScoreCache::capacity() const
+{
+    return mask + 1;
+}
+
+/* HELPER METHOD: home - gets the position at which probing for a key starts
+ * - keys of neighbouring rows differ only in a few low digits, so they are mixed before masking
+*/
+uint64_t ScoreCache::home(uint64_t key) const
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return key & mask;
+}
+
+/* HELPER METHOD: compact_dependents - drops every stale pair from the inverted index
+ * - called whenever the pairs outnumber twice what the live entries could need, so the index stays bounded
+*/
+void ScoreCache::compact_dependents()
+{
+    dependent_count = 0;
+    for (std::vector<std::pair<uint32_t, uint32_t>> &list : dependents) {
+        uint64_t kept = 0;
+        for (uint64_t idx = 0; idx < list.size(); idx++)
+            if (generation[list[idx].first] == list[idx].second) list[kept++] = list[idx];
+        list.resize(kept);
+        dependent_count += kept;
+    }
+}
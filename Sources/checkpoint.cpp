@@ -0,0 +1,169 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
+| Specifically, the methods for saving a checkpoint of a run in progress and picking it back up are found   |
+| here. A checkpoint holds everything that adding rows has changed since the constructor: the rows, the     |
+| scores and issue counts, the coverage and detectability flags, the location classes, the separations, the |
+| heuristic in use, the column order, and the seed and state of rng. What the constructor builds the same   |
+| way every time (the Singles, Interactions, and tables for ranking) is not saved, but built again as       |
+| usual before the checkpoint is loaded over it. The sets of rows each Single and Interaction occurs in are |
+| not saved either, since they take far more room than the rows they come from; they are rebuilt from the   |
+| rows in one pass instead. Anything else is scratch space, or only lasts for one row.                      |
+|===========================================================================================================|
+*/
+
+#include "array.h"
+#include <string.h>
+
+// marks the start of a checkpoint file, and which layout it has
+static const char CHECKPOINT_MAGIC[8] = {'A', 'G', 'C', 'K', 'P', 'T', '0', '3'};
+
+/* UTILITY METHOD: save_checkpoint - writes a checkpoint of the array as it is now
+ * - should only be called between rows, so that nothing is half updated
+ *
+ * parameters:
+ * - filename: path of the file to write; whatever it had is only replaced once the new checkpoint is whole
+ *
+ * returns:
+ * - true if the checkpoint was written, false otherwise (in which case a message will have been printed)
+*/
+bool Array::save_checkpoint(const std::string &filename)
+{
+    SnapshotWriter out;
+    if (!out.open(filename)) {
+        printf("NOTE: could not open <%s> for writing a checkpoint; skipped\n", filename.c_str());
+        return false;
+    }
+
+    // what the checkpoint is for, so that it is never loaded into a different array
+    out.put(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    out.put_u64(p); out.put_u64(d); out.put_u64(t); out.put_u64(delta);
+    std::vector<uint16_t> levels(num_factors);
+    for (uint16_t col = 0; col < num_factors; col++) levels[col] = factors[col]->level;
+    out.put_u16s(levels);
+    out.put_u64(interactions.size());
+    out.put_u64(num_sets);
+
+    // the rows, and the overall state
+    out.put_u64(num_tests);
+    out.put_u16s(rows);
+    out.put_u64(score);
+    out.put_u64(coverage_problems); out.put_u64(location_problems); out.put_u64(detection_problems);
+    out.put_u64(is_covering); out.put_u64(is_locating); out.put_u64(is_detecting);
+    out.put_u64(heuristic_in_use);
+    out.put(permutation, num_factors*sizeof(uint16_t));
+    out.put_u64(seed);
+    out.put(rng.state, sizeof(rng.state));
+
+    // per factor and per Single
+    for (uint16_t col = 0; col < num_factors; col++) {
+        out.put_u64(dont_cares[col]);
+        out.put_u64(factors[col]->c_issues); out.put_u64(factors[col]->l_issues);
+        out.put_u64(factors[col]->d_issues);
+    }
+    out.put_u64s(c_issues); out.put_u64s(l_issues); out.put_u64s(d_issues);
+
+    // per Interaction, and location and detection; the vectors that were never built are simply empty
+    out.put_u8s(is_covered); out.put_u8s(is_detectable);
+    out.put_u64s(set_order); out.put_u64s(set_position); out.put_u64s(set_class);
+    out.put_u64s(class_start); out.put_u64s(class_size);
+    out.put_u64s(unseen_sets);
+    out.put_u8s(separations); out.put_u64s(active_blocks); out.put_u64s(active_block_count);
+
+    if (!out.commit()) {
+        printf("NOTE: could not write a checkpoint into <%s>; skipped\n", filename.c_str());
+        return false;
+    }
+    if (o == normal) printf("Saved checkpoint with %lu rows into <%s>.\n", num_tests, filename.c_str());
+    return true;
+}
+
+/* UTILITY METHOD: load_checkpoint - picks up a run from a checkpoint written by save_checkpoint()
+ * - must be called right after the constructor, before any rows are added; the checkpoint must have been
+ *   made with the same input and the same d, t, and δ
+ *
+ * parameters:
+ * - filename: path of the checkpoint
+ *
+ * returns:
+ * - true if the array now is just as it was when the checkpoint was saved, false otherwise (in which case
+ *   a message will have been printed, and the array should not be used further)
+*/
+bool Array::load_checkpoint(const std::string &filename)
+{
+    SnapshotReader in;
+    if (!in.open(filename)) {
+        printf("ERROR: could not open checkpoint <%s>\n", filename.c_str());
+        return false;
+    }
+
+    char magic[sizeof(CHECKPOINT_MAGIC)];
+    if (!in.get(magic, sizeof(magic)) || memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0) {
+        printf("ERROR: <%s> is not a checkpoint\n", filename.c_str());
+        return false;
+    }
+    bool same = in.get_u64() == p;
+    same = in.get_u64() == d && same;
+    same = in.get_u64() == t && same;
+    same = in.get_u64() == delta && same;
+    std::vector<uint16_t> levels;
+    same = in.get_u16s(&levels, true) && levels.size() == num_factors && same;
+    for (uint16_t col = 0; same && col < num_factors; col++) same = levels[col] == factors[col]->level;
+    same = in.get_u64() == interactions.size() && same;
+    same = in.get_u64() == num_sets && same;
+    if (!same) {
+        printf("ERROR: checkpoint <%s> was made for a different array or with different arguments\n",
+            filename.c_str());
+        return false;
+    }
+
+    num_tests = in.get_u64();
+    in.get_u16s(&rows, true);
+    score = in.get_u64();
+    coverage_problems = in.get_u64(); location_problems = in.get_u64(); detection_problems = in.get_u64();
+    is_covering = in.get_u64(); is_locating = in.get_u64(); is_detecting = in.get_u64();
+    heuristic_in_use = static_cast<prop_mode>(in.get_u64());
+    in.get(permutation, num_factors*sizeof(uint16_t));
+    seed = in.get_u64();
+    in.get(rng.state, sizeof(rng.state));
+    for (uint16_t col = 0; col < num_factors; col++) {
+        dont_cares[col] = static_cast<prop_mode>(in.get_u64());
+        factors[col]->c_issues = in.get_u64(); factors[col]->l_issues = in.get_u64();
+        factors[col]->d_issues = in.get_u64();
+    }
+    in.get_u64s(&c_issues); in.get_u64s(&l_issues); in.get_u64s(&d_issues);
+    in.get_u8s(&is_covered); in.get_u8s(&is_detectable);
+    in.get_u64s(&set_order); in.get_u64s(&set_position); in.get_u64s(&set_class);
+    in.get_u64s(&class_start, true); in.get_u64s(&class_size, true);
+    in.get_u64s(&unseen_sets);
+    in.get_u8s(&separations); in.get_u64s(&active_blocks); in.get_u64s(&active_block_count);
+
+    bool valid = in.at_end() && rows.size() == num_tests*num_factors &&
+        class_start.size() == class_size.size();
+    for (uint64_t idx = 0; valid && idx < rows.size(); idx++)
+        valid = rows[idx] < factors[idx % num_factors]->level;
+    if (!valid) {
+        printf("ERROR: checkpoint <%s> is damaged\n", filename.c_str());
+        return false;
+    }
+
+    // rebuild what was left out, one row at a time, numbering rows from 1 as update_array() does
+    std::vector<Interaction*> row_interactions;
+    for (uint64_t row = 0; row < num_tests; row++) {
+        uint16_t *values = &rows[row*num_factors];
+        for (uint16_t col = 0; col < num_factors; col++)
+            factors[col]->singles[values[col]].rows.insert(row + 1);
+        row_interactions.clear();
+        build_row_interactions(values, &row_interactions);
+        for (Interaction *i : row_interactions) i->rows.insert(row + 1);
+    }
+    for (Interaction *i : interactions) if (is_covered[i->rank]) mark_covered(i);
+    class_split.assign(class_size.size(), 0);
+    worst_heap_valid = false;
+    if (score_cache) score_cache->invalidate_all();
+
+    if (o != silent) printf("Resumed from checkpoint <%s> with %lu rows.\n", filename.c_str(), num_tests);
+    return true;
+}
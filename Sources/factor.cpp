@@ -1,11 +1,11 @@
 /* Array-Generator by Isaac Jung
-Last updated 11/14/2022
+Last updated 10/17/2026
 
 |===========================================================================================================|
-|   This file contains mostly just constructors and deconstructors for the Single and Factor classes. The   |
-| Single class also has a to_string() method, used for building reconstructable keys into a map used by the |
-| Array module (see array.cpp for more details). The purpose of Single and Factor objects is described in   |
-| this module's header file, factor.h.
+|   This file contains just constructors for the Single and Factor classes. The Single class also has a     |
+| to_string() method, which the Array module builds on to name Interactions and sets of them in debug       |
+| output (see array.cpp for more details). The purpose of Single and Factor objects is described in this    |
+| module's header file, factor.h.                                                                           |
 |===========================================================================================================|
 */
 
@@ -15,7 +15,8 @@ Last updated 11/14/2022
 /* CONSTRUCTOR - initializes the object
  * - overloaded: this version can set its fields based on parameters
 */
-Single::Single(uint64_t f, uint64_t v) : factor(f), value(v), str_rep(this->to_string_internal())
+Single::Single(uint64_t f, uint64_t v, uint32_t i) : id(i), factor(f), value(v),
+    str_rep(this->to_string_internal())
 {
     // rows will be built later
 }
@@ -24,7 +25,7 @@ Single::Single(uint64_t f, uint64_t v) : factor(f), value(v), str_rep(this->to_s
  * 
  * returns:
  * - a string representing the Single
- *  --> This is not to be used for printing; rather, it is for mapping unique strings to their Singles
+ *  --> This is only meant for debug output, since ids are what identify Singles
 */
 std::string Single::to_string() const
 {
@@ -45,15 +46,7 @@ std::string Single::to_string_internal() const
 /* CONSTRUCTOR - initializes the object
  * - overloaded: this version can set its fields based on parameters
 */
-Factor::Factor(uint16_t i, uint16_t l, Single **ptr_array) : id(i), level(l)
+Factor::Factor(uint16_t i, uint16_t l, Single *first) : id(i), level(l)
 {
-    singles = ptr_array;
-}
-
-/* DECONSTRUCTOR - frees memory
-*/
-Factor::~Factor()
-{
-    for (uint16_t i = 0; i < level; i++) delete singles[i];
-    delete[] singles;
+    singles = first;
 }
\ No newline at end of file
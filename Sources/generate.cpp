@@ -1,5 +1,5 @@
 /* Array-Generator by Isaac Jung
-Last updated 12/22/2022
+Last updated 10/17/2026
 
 |===========================================================================================================|
 |   This file contains the main() method which reflects the high level flow of the program. It starts by    |
@@ -14,9 +14,9 @@ Last updated 12/22/2022
 | reason, the array cannot be completed, main() attempts to detect this and stop early, rather than get     |
 | caught in an infinite loop. In this case, whatever was able to be generated will still be saved/printed,  |
 | along with a warning to the user about the failure.                                                       |
-|   Other classes used by this program are: Single, Factor, Interaction, T, Prev_S_Data, Prev_I_Data, and   |
+|   Other classes used by this program are: Single, Factor, Interaction, Prev_S_Data, Prev_I_Data, and      |
 | Prev_T_Data. The Single and Factor classes can be found in the factor.h and factor.cpp files. The         |
-| Interaction and T classes can be found in the array.h and array.cpp files. All of the Prev_x_data classes |
+| Interaction class can be found in the array.h and array.cpp files. All of the Prev_x_data classes        |
 | are self-contained in heuristics.cpp, and do not need to be used by other modules. Here are general       |
 | descriptions of how all of the classes in this program are intended to be used:                           |
 | - Parser: parses input from the user to set flags and get info about the array to be generated            |
@@ -24,7 +24,8 @@ Last updated 12/22/2022
 | - Single: simple struct-like class for use by the Array object, representing a (factor, value)            |
 | - Factor: another struct-like class that associates lists of Singles with their corresponding factors     |
 | - Interaction: struct-like class to group Singles together, fundamental to the defining of coverage       |
-| - T: struct-like class to group Interactions together, fundamental to defining location and detection     |
+| - T sets: size-d sets of Interactions, fundamental to defining location and detection; these are never     |
+|   stored as objects, but are identified by their rank (see Array::rank_set)                               |
 |===========================================================================================================|
 */
 
@@ -49,8 +50,9 @@ static prop_mode pm;    // property mode
 // =========================v=v=v== static methods - forward declarations ==v=v=v========================= //
 
 static int32_t print_usage();
-static int32_t print_results(Parser *p, Array *array, bool success);
+static int32_t print_results(Parser *p, Array *array, RowSink *sink, bool success);
 static void debug_print(uint8_t d, uint8_t t, uint8_t delta);
+static PackedHeader packed_header(Parser *p, Array *array);
 
 // =========================^=^=^== static methods - forward declarations ==^=^=^========================= //
 
@@ -80,22 +82,35 @@ int32_t main(int32_t argc, char *argv[])
         printf("Nothing to do.\n\n");
         return 0;
     }
-    for (uint16_t *row : p.array) array.add_row(row);   // add any partial array rows, if given
+    bool resuming = !p.resume_filename.empty();
+    if (resuming && !array.load_checkpoint(p.resume_filename)) return 1;   // pick up where a run left off
+    RowSink sink(p.flush_seconds);  // rows go into the output file as they are added, if there is one
+    if (p.binary && p.out_filename.empty()) printf("NOTE: --binary needs an output file; printing as text\n");
+    if (!p.out_filename.empty() && (p.binary ? sink.open_packed(p.out_filename, packed_header(&p, &array)) :
+        sink.open(p.out_filename))) array.stream_rows(&sink);
+    if (resuming && p.has_seed) printf("NOTE: resuming from a checkpoint, so --seed is ignored\n");
+    if (resuming && !p.array.empty()) printf("NOTE: resuming from a checkpoint, so --partial is ignored\n");
+    else array.add_rows(p.array.data(), p.num_rows);    // add any partial array rows, if given
 
     array.print_stats(true);        // report initial state of array
     if (array.score == 0) return 0; // when the partial array already solved all problems
     uint64_t prev_score;            // for comparing to current score to see if nothing is changing
     uint8_t no_change_counter = 0;  // need this to stop an infinite loop if the array cannot be completed
+    uint64_t since_checkpoint = 0;  // rows added since the last checkpoint was saved
     while (array.score > 0) {       // add rows until the array is complete
         prev_score = array.score;   // needed for catching impossible scenarios
         array.add_row();            // add another row
         if (array.out_of_memory) break;
+        if (!p.checkpoint_filename.empty() && ++since_checkpoint >= p.checkpoint_every) {
+            array.save_checkpoint(p.checkpoint_filename);
+            since_checkpoint = 0;
+        }
         if (array.score == prev_score) no_change_counter++;
         else no_change_counter = 0;
         if (no_change_counter > 10) break;
         array.print_stats();        // report current state of array
     }
-    return print_results(&p, &array, (no_change_counter == 0 || array.out_of_memory));
+    return print_results(&p, &array, &sink, (no_change_counter == 0 || array.out_of_memory));
 }
 
 /* HELPER METHOD: print_usage - prints info about the usage of the program
@@ -112,6 +127,14 @@ static int32_t print_usage()
     printf("\t-s          : silent mode (prints no output, cancels other output flags)\n");
     printf("\t-v          : verbose mode (prints more output than normal)\n");
     printf("\t--partial   : use partially complete array; a filepath must follow this flag\n");
+    printf("\t--score-cache : memory cap in MiB for remembered row scores (default 64); a size must follow\n");
+    printf("\t--memory-budget : memory cap in MiB for the whole run (default none); a size must follow\n");
+    printf("\t--flush-every : most seconds rows wait to be written to the output file (default 1)\n");
+    printf("\t--checkpoint : file to save the run's state into every so often; a filepath must follow\n");
+    printf("\t--checkpoint-every : rows added between checkpoints (default 10); a number must follow\n");
+    printf("\t--resume    : pick up a run from a checkpoint; a filepath must follow\n");
+    printf("\t--binary    : write the output file in the packed binary format instead of text\n");
+    printf("\t--seed      : seed for random choices, so runs can be repeated (default current time)\n");
     printf("\t--help      : print help message (what you are seeing here)\n");
     printf("arguments (assume order matters):\n");
     printf("\tt           : strength of interactions, needed for all types of arrays\n");
@@ -124,17 +147,19 @@ static int32_t print_usage()
 }
 
 /* SUB METHOD: print_results - prints the completion status after the array is finished being generated
+ * - when an output file was given, the rows are already in it (see Array::stream_rows()), so all that is left
+ *   is to flush the last of them; otherwise, they are printed to stdout here
  * 
  * parameters:
  * - p: Parser object that has already had its process_input() method called
  * - array: Array object that has already been completely constructed
- * - row_count: number of rows that have been added to the array
+ * - sink: RowSink that has been streaming the rows into the output file, or that could not open it
  * - success: whether the array was completed with all requested properties satisfied or not
  * 
  * returns:
  * - exit code representing the state of the program (0 means the program finished successfully)
 */
-static int32_t print_results(Parser *p, Array *array, bool success)
+static int32_t print_results(Parser *p, Array *array, RowSink *sink, bool success)
 {
     if (!success) {
         printf("\nWARNING: It appears impossible to complete array with requested properties.\n");
@@ -145,23 +170,22 @@ static int32_t print_results(Parser *p, Array *array, bool success)
     if (p->out_filename.empty()) {
         if (!success) printf("The array up to this point was:\n");
         else if (om != silent) printf("The finished array is:\n");
-        printf("%s\n", array->to_string().c_str());
+        RowSink out(p->flush_seconds);
+        out.open(stdout);
+        array->write_rows(&out);
+        out.close();
+        printf("\n");
+    } else if (!sink->is_open() || !sink->close()) {
+        RowSink out(p->flush_seconds);
+        out.open(stdout);
+        if (!success) {
+            printf("Tried to write what rows the array had into file, but an error occurred.\n");
+            printf("Please manually copy-paste it if needed:\n");
+        } else printf("Error opening file for writing. Please manually copy-paste the array as needed:\n");
+        array->write_rows(&out);
+        out.close();
+        printf("\n");
     } else {
-        try {
-            p->out.open(p->out_filename.c_str(), std::ofstream::out);
-        } catch ( ... ) {
-            if (!success) {
-                printf("Tried to write what rows the array had into file, but an error occurred.\n");
-                printf("Please manually copy-paste it if needed:\n%s\n", array->to_string().c_str());
-                return 0;
-            }
-            printf("Error opening file for writing. Please manually copy-paste the array as needed:\n%s\n",
-                array->to_string().c_str());
-            return 0;
-        }
-        std::string str = array->to_string();
-        p->out.write(str.c_str(), static_cast<std::streamsize>(str.size()));
-        p->out.close();
         if (!success) {
             printf("Wrote what rows the array had up to this point into file with path name <./%s>.\n\n",
                 p->out_filename.c_str());
@@ -217,4 +241,24 @@ static void debug_print(uint8_t d, uint8_t t, uint8_t delta) {
         exit(1);
     }
     printf("\n");
-}
\ No newline at end of file
+}
+
+/* HELPER METHOD: packed_header - fills in the header of a packed output file (see packed.h)
+ * 
+ * parameters:
+ * - p: Parser object that has already had its process_input() method called
+ * - array: Array object that has already been completely constructed
+ * 
+ * returns:
+ * - the header, less the number of rows, which is only known once the array is finished
+*/
+static PackedHeader packed_header(Parser *p, Array *array)
+{
+    PackedHeader header;
+    header.levels = p->levels;
+    header.d = pm == c_only ? 0 : p->d;     // 0 for whatever was not asked for
+    header.t = p->t;
+    header.delta = pm == all ? p->delta : 0;
+    header.seed = array->seed;
+    return header;
+}
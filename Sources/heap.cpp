@@ -0,0 +1,123 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the IndexedHeap class declared in heap.h.       |
+|===========================================================================================================|
+*/
+
+#include "heap.h"
+#include <algorithm>
+
+/* UTILITY METHOD: build - replaces the contents of the heap
+ * - takes linear time, by sifting down every id that has children, from the last one back to the root
+ *
+ * parameters:
+ * - keys_o: the key of every id, indexed by id
+ *
+ * returns:
+ * - void, but after the method finishes, the heap will hold the ids [0, keys_o.size())
+*/
+void IndexedHeap::build(const std::vector<uint64_t> &keys_o)
+{
+    keys = keys_o;
+    heap.resize(keys.size());
+    position.resize(keys.size());
+    for (uint64_t id = 0; id < keys.size(); id++) heap[id] = position[id] = id;
+    for (uint64_t pos = heap.size()/2; pos-- > 0;) sift_down(pos);
+}
+
+/* UTILITY METHOD: update - changes the key of an id, moving it to wherever it now belongs
+ *
+ * parameters:
+ * - id: the id whose key changed, in the range [0, n)
+ * - key: its new key
+*/
+void IndexedHeap::update(uint64_t id, uint64_t key)
+{
+    uint64_t old_key = keys[id];
+    keys[id] = key;
+    if (key > old_key) sift_up(position[id]);
+    else if (key < old_key) sift_down(position[id]);
+}
+
+/* UTILITY METHOD: top_key - gets the largest key of any id
+*/
+uint64_t IndexedHeap::top_key() const
+{
+    return keys[heap[0]];
+}
+
+/* UTILITY METHOD: top_ties - gets every id whose key is the largest
+ * - only the part of the heap holding the largest key is visited; since no id's key is more than its
+ *   parent's, an id tied for the largest can only have a parent that is tied as well
+ *
+ * parameters:
+ * - ids: pointer to vector to which the ids should be appended, in increasing order
+*/
+void IndexedHeap::top_ties(std::vector<uint64_t> *ids) const
+{
+    if (heap.empty()) return;
+    uint64_t first = ids->size();
+    std::vector<uint64_t> pending(1, 0);    // positions still to visit, all holding the largest key
+    while (!pending.empty()) {
+        uint64_t pos = pending.back();
+        pending.pop_back();
+        ids->push_back(heap[pos]);
+        for (uint64_t child = 2*pos + 1; child <= 2*pos + 2 && child < heap.size(); child++)
+            if (keys[heap[child]] == keys[heap[0]]) pending.push_back(child);
+    }
+    std::sort(ids->begin() + static_cast<int64_t>(first), ids->end());
+}
+
+/* UTILITY METHOD: empty - checks whether the heap has no ids
+*/
+bool IndexedHeap::empty() const
+{
+    return heap.empty();
+}
+
+/* HELPER METHOD: sift_up - swaps an id with its parent until its parent's key is no less than its own
+ *
+ * parameters:
+ * - pos: index in heap of the id to move
+*/
+void IndexedHeap::sift_up(uint64_t pos)
+{
+    uint64_t id = heap[pos];
+    while (pos > 0 && keys[heap[(pos - 1)/2]] < keys[id]) {
+        place(pos, heap[(pos - 1)/2]);
+        pos = (pos - 1)/2;
+    }
+    place(pos, id);
+}
+
+/* HELPER METHOD: sift_down - swaps an id with its larger child until neither child's key is more than its own
+ *
+ * parameters:
+ * - pos: index in heap of the id to move
+*/
+void IndexedHeap::sift_down(uint64_t pos)
+{
+    uint64_t id = heap[pos];
+    while (2*pos + 1 < heap.size()) {
+        uint64_t child = 2*pos + 1;
+        if (child + 1 < heap.size() && keys[heap[child + 1]] > keys[heap[child]]) child++;
+        if (keys[heap[child]] <= keys[id]) break;
+        place(pos, heap[child]);
+        pos = child;
+    }
+    place(pos, id);
+}
+
+/* HELPER METHOD: place - puts an id at a position in the heap
+ *
+ * parameters:
+ * - pos: index in heap
+ * - id: the id to put there
+*/
+void IndexedHeap::place(uint64_t pos, uint64_t id)
+{
+    heap[pos] = id;
+    position[id] = pos;
+}
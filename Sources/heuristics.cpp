@@ -1,5 +1,5 @@
 /* Array-Generator by Isaac Jung
-Last updated 12/30/2022
+Last updated 10/17/2026
 
 |===========================================================================================================|
 |   This file contains definitions for methods belonging to the Array class which are declared in array.h.  |
@@ -13,6 +13,9 @@ Last updated 12/30/2022
 #include <unistd.h>
 #include <algorithm>
 
+// method forward declarations
+static uint16_t least_index(const uint64_t *values, uint16_t count);
+
 /* SUB METHOD: add_row - adds a new row to the array using some predictive and scoring logic
  * - simply an interface for adding a row; method itself simply decides which heuristic to use
  * 
@@ -23,7 +26,7 @@ void Array::add_row()
 {
     // choose a new random order for the column iterations this round
     for (uint16_t size = num_factors; size > 0; size--) {
-        uint16_t rand_idx = rand() % size;
+        uint16_t rand_idx = static_cast<uint16_t>(rng.below(size));
         uint16_t temp = permutation[size - 1];
         permutation[size - 1] = permutation[rand_idx];
         permutation[rand_idx] = temp;
@@ -32,7 +35,7 @@ void Array::add_row()
     // choose how to initialize the new row based on current heuristic to be used
     uint16_t *new_row;
     Interaction *locked_interaction = nullptr;
-    T *locked_set = nullptr;
+    uint64_t locked_set = 0;
     switch (heuristic_in_use) {
         case c_only:
         case c_and_l:
@@ -72,6 +75,7 @@ void Array::add_row()
     
     // tweak the row based on the current heuristic and then add to the array
     update_array(new_row);
+    delete[] new_row;
 }
 
 /* SUB METHOD: add_row - adds a new row to the array
@@ -85,10 +89,7 @@ void Array::add_row()
 */
 void Array::add_row(uint16_t *row)
 {
-    uint16_t *new_row = new uint16_t[num_factors];
-    for (uint16_t idx = 0; idx < num_factors; idx++) new_row[idx] = row[idx];
-    update_array(new_row);
-    just_switched_heuristics = true;    // keeps heuristic_all from breaking if called right away
+    update_array(row);
 }
 
 /* SUB METHOD: initialize_row_R - creates a randomly generated row
@@ -100,7 +101,7 @@ uint16_t *Array::initialize_row_R()
 {
     uint16_t *new_row = new uint16_t[num_factors];
     for (uint16_t i = 0; i < num_factors; i++)
-        new_row[i] = rand() % factors[i]->level;
+        new_row[i] = static_cast<uint16_t>(rng.below(factors[i]->level));
     return new_row;
 }
 
@@ -121,32 +122,49 @@ uint16_t *Array::initialize_row_R(Interaction **locked, std::vector<Interaction*
 {
     uint16_t *new_row = initialize_row_R();
 
-    uint64_t worst_count = 0;
     std::vector<Interaction*> worst_interactions;   // there could be ties for the worst
     std::vector<Interaction*> *to_use = ties;   // assume ties will hold the worst interactions
     if (!to_use) to_use = &worst_interactions;  // if ties is nullptr, just use local
-    for (Interaction *interaction : interactions) {
-        uint64_t cur_count = 4*(num_tests - interaction->rows.size());  // bias towards picking unsued ones
-        for (Single *s : interaction->singles)
-            cur_count += s->c_issues + s->l_issues + s->d_issues;
-        if (cur_count >= worst_count) {     // worse or tied
-            if (cur_count > worst_count) {  // strictly worse
-                worst_count = cur_count;
-                to_use->clear();
-            }
-            to_use->push_back(interaction);
-        }
+    if (!worst_heap_valid) {    // first time, or too much changed since the last time to keep it up to date
+        std::vector<uint64_t> keys(interactions.size());
+        for (Interaction *interaction : interactions) keys[interaction->rank] = worst_key(interaction);
+        worst_heap.build(keys);
+        worst_heap_valid = true;
     }
+    std::vector<uint64_t> worst_ranks;
+    worst_heap.top_ties(&worst_ranks);  // in order of rank, as a scan over the interactions would find them
+    for (uint64_t rank : worst_ranks) to_use->push_back(interactions[rank]);
     if (ties && to_use->size() > 1) return new_row; // when caller intends to judge ties itself
 
     // choose the interaction with most Single issues (for ties, choose randomly from among those tied)
-    *locked = to_use->at(static_cast<uint64_t>(rand()) % to_use->size());
+    *locked = to_use->at(rng.below(to_use->size()));
     for (Single *s : (*locked)->singles) new_row[s->factor] = s->value;
     if (debug == d_on) printf("==%d== Locking interaction %s\n", getpid(), (*locked)->to_string().c_str());
     return new_row;
 }
 
-/* SUB METHOD: initialize_row_S - creates a row by considering which Singles have the most issues
+/* HELPER METHOD: worst_key - gets how much attention an Interaction needs, for initialize_row_R()
+ * - this is the total issues of its Singles, plus 4 for every row it does not occur in, to bias towards
+ *   picking unused ones; rows are counted down from a fixed ceiling rather than from num_tests, which
+ *   shifts every key by the same amount, so that adding a row only changes the keys of the Interactions in it
+ * 
+ * parameters:
+ * - i: the Interaction
+ * 
+ * returns:
+ * - the key of the Interaction in worst_heap
+*/
+uint64_t Array::worst_key(Interaction *i) const
+{
+    uint64_t key = 4*(UINT32_MAX - i->rows.size());
+    for (Single *s : i->singles) key += c_issues[s->id] + l_issues[s->id] + d_issues[s->id];
+    return key;
+}
+
+/* SUB METHOD: initialize_row_S - creates a row by considering which Singles would cover the most
+ * - each column's value is the one that would complete the most uncovered Interactions with the columns
+ *   placed before it; ties (including all of the columns placed before t-1 others are) go to whichever
+ *   Single has the most issues
  * 
  * returns:
  * - a pointer to the first element in the array that represents the row
@@ -154,6 +172,8 @@ uint16_t *Array::initialize_row_R(Interaction **locked, std::vector<Interaction*
 uint16_t* Array::initialize_row_S()
 {
     uint16_t *new_row = new uint16_t[num_factors]{0};
+    bool *placed = new bool[num_factors]{false};    // which columns have their values so far
+    std::vector<uint32_t> gains;
 
     // greedily select the values that appear to need the most attention
     for (uint16_t col = 0; col < num_factors; col++) {
@@ -161,55 +181,67 @@ uint16_t* Array::initialize_row_S()
         if ((p == all && dont_cares[permutation[col]] == all) ||
             (p == c_and_l && dont_cares[permutation[col]] == c_and_l) ||
             (p == c_only && dont_cares[permutation[col]] == c_only)) {
-            new_row[permutation[col]] = rand() % factors[permutation[col]]->level;
+            new_row[permutation[col]] = static_cast<uint16_t>(rng.below(factors[permutation[col]]->level));
+            placed[permutation[col]] = true;
             continue;
         }
-        // assume 0 is the worst to start, then check if any others are worse
-        Single *worst_single = factors[permutation[col]]->singles[0];
-        uint64_t worst_score = worst_single->c_issues/3 + worst_single->l_issues/2 + worst_single->d_issues;
-        for (uint16_t val = 1; val < factors[permutation[col]]->level; val++) {
-            Single *cur_single = factors[permutation[col]]->singles[val];
-            uint64_t cur_score = cur_single->c_issues/3 + cur_single->l_issues/2 + cur_single->d_issues;
-            if (cur_score > worst_score || (cur_score == worst_score && rand() % 2 == 0)) {
-                worst_single = cur_single;
-                worst_score = cur_score;
+        // assume 0 is the best to start, then check if any others are better; a factor's Singles have
+        // consecutive ids, so this scans a contiguous stretch of each of the issue arrays
+        Factor *f = factors[permutation[col]];
+        gains.resize(f->level);
+        column_gains(new_row, permutation[col], placed, gains.data());
+        uint32_t first = f->singles[0].id;
+        uint16_t best_val = 0;
+        uint64_t best_score = c_issues[first]/3 + l_issues[first]/2 + d_issues[first];
+        for (uint16_t val = 1; val < f->level; val++) {
+            if (gains[val] < gains[best_val]) continue;
+            uint64_t cur_score = c_issues[first + val]/3 + l_issues[first + val]/2 + d_issues[first + val];
+            if (gains[val] > gains[best_val] || cur_score > best_score ||
+                (cur_score == best_score && rng.below(2) == 0)) {
+                best_val = val;
+                best_score = cur_score;
             }
         }
-        new_row[permutation[col]] = worst_single->value;
+        new_row[permutation[col]] = best_val;
+        placed[permutation[col]] = true;
     }   // entire row is now initialized based on the greedy approach
+    delete[] placed;
     return new_row;
 }
 
 /* SUB METHOD: initialize_row_T - creates a row by considering which T sets have the most location conflicts
  * 
  * parameters:
- * - l_set: pointer to T* that will drive a scoring heuristic later
- *  --> *l_set should be nullptr when passed in as a parameter; this method will assign the value
+ * - l_set: pointer to the rank of the T set that will drive a scoring heuristic later
+ *  --> this method will assign the value
  * - l_interaction: pointer to Interaction* that will drive a scoring heuristic later
  *  --> *l_interaction should be nullptr when passed in as a parameter; this method will assign the value
  *
  * returns:
  * - a pointer to the first element in the array that represents the row
 */
-uint16_t *Array::initialize_row_T(T **l_set, Interaction **l_interaction)
+uint16_t *Array::initialize_row_T(uint64_t *l_set, Interaction **l_interaction)
 {
     std::vector<Interaction*> ties;
     uint16_t *new_row = initialize_row_R(l_interaction, &ties);
     
+    // a T set that has not occurred yet conflicts with every other T set, which no other T set can match; so
+    // if any candidate is in such a set, the candidates in none can be passed over without visiting their sets
+    bool any_unseen = false;
+    for (Interaction *i : ties) any_unseen = any_unseen || unseen_sets[i->rank] > 0;
+
     uint64_t worst_count = 0;
-    std::vector<T*> worst_sets, working_sets;
-    for (T *t_set : sets) { // for all T sets,
-        std::vector<Interaction*> *vec = &t_set->interactions;
-        for (Interaction *i : ties) // for each Interaction in the list of candidates by issues,
-            if (std::find(vec->begin(), vec->end(), i) != vec->end()) { // if this set contains one of those,
-                working_sets.push_back(t_set);  // keep this set in the list of potential choices
-                break;
-            }
-    }
-    for (T *t_set : working_sets) {
-        if (t_set->location_conflicts.size() >= worst_count) {      // worse or tied
-            if (t_set->location_conflicts.size() > worst_count) {   // strictly worse
-                worst_count = t_set->location_conflicts.size();
+    std::vector<uint64_t> worst_sets, working_sets;
+    for (Interaction *i : ties) // for each Interaction in the list of candidates by issues,
+        if (!any_unseen || unseen_sets[i->rank] > 0)
+            sets_containing(i->rank, &working_sets);    // keep the sets containing it as potential choices
+    std::sort(working_sets.begin(), working_sets.end());    // a set may contain several of the candidates
+    working_sets.erase(std::unique(working_sets.begin(), working_sets.end()), working_sets.end());
+    for (uint64_t t_set : working_sets) {
+        uint64_t cur_count = location_conflicts(t_set);
+        if (cur_count >= worst_count) {     // worse or tied
+            if (cur_count > worst_count) {  // strictly worse
+                worst_count = cur_count;
                 worst_sets.clear();
             }
             worst_sets.push_back(t_set);
@@ -217,17 +249,19 @@ uint16_t *Array::initialize_row_T(T **l_set, Interaction **l_interaction)
     }
 
     // choose the set with most conflicts (for ties, choose randomly from among those tied)
-    *l_set = worst_sets.at(static_cast<uint64_t>(rand()) % worst_sets.size());
+    *l_set = worst_sets.at(rng.below(worst_sets.size()));
     if (ties.size() == 1) {
-        if (debug == d_on) printf("==%d== Locking t_set %s\n", getpid(), (*l_set)->to_string().c_str());
+        if (debug == d_on) printf("==%d== Locking t_set %s\n", getpid(), set_to_string(*l_set).c_str());
         return new_row;
     }
 
-    *l_interaction = (*l_set)->interactions.at(static_cast<uint64_t>(rand()) % (*l_set)->interactions.size());
+    std::vector<uint64_t> members(d);
+    unrank_set(*l_set, members.data());
+    *l_interaction = interactions[members.at(rng.below(members.size()))];
     for (Single *s : (*l_interaction)->singles) new_row[s->factor] = s->value;
     if (debug == d_on) {
         printf("==%d== Locking interaction %s\n", getpid(), (*l_interaction)->to_string().c_str());
-        printf("==%d== Locking t_set %s\n", getpid(), (*l_set)->to_string().c_str());
+        printf("==%d== Locking t_set %s\n", getpid(), set_to_string(*l_set).c_str());
     }
     return new_row;
 }
@@ -249,10 +283,12 @@ uint16_t *Array::initialize_row_I(Interaction **locked)
 
     uint64_t worst_count = 0;
     std::vector<Interaction*> worst_interactions;   // there could be ties for the worst
+    std::vector<uint64_t> unseparated;
     for (Interaction *interaction : ties) {
         uint64_t cur_count = 0;
-        for (auto &kv : interaction->deltas)
-            if (kv.second < delta) cur_count += delta - kv.second;
+        unseparated.clear();
+        unseparated_sets(interaction, &unseparated);
+        for (uint64_t rank : unseparated) cur_count += delta - separation(interaction, rank);
         if (cur_count >= worst_count) {     // worse or tied
             if (cur_count > worst_count) {  // strictly worse
                 worst_count = cur_count;
@@ -263,7 +299,7 @@ uint16_t *Array::initialize_row_I(Interaction **locked)
     }
 
     // choose the interaction with lowest separation (for ties, choose randomly from among those tied)
-    *locked = worst_interactions.at(static_cast<uint64_t>(rand()) % worst_interactions.size());
+    *locked = worst_interactions.at(rng.below(worst_interactions.size()));
     for (Single *s : (*locked)->singles) new_row[s->factor] = s->value;
     if (debug == d_on) printf("==%d== Locking interaction %s\n", getpid(), (*locked)->to_string().c_str());
     return new_row;
@@ -286,8 +322,8 @@ void Array::heuristic_c_only(uint16_t *row)
     prop_mode *dont_cares_c = new prop_mode[num_factors];   // local copy of the don't cares
     for (uint16_t col = 0; col < num_factors; col++) dont_cares_c[col] = dont_cares[col];
 
-    std::set<Interaction*> row_interactions;
-    build_row_interactions(row, &row_interactions, 0, t, "");
+    std::vector<Interaction*> row_interactions;
+    build_row_interactions(row, &row_interactions);
     for (Interaction *i : row_interactions) {
         if (i->rows.size() != 0) {  // Interaction is already covered
             bool can_skip = false;  // don't account for Interactions involving already-completed factors
@@ -314,22 +350,34 @@ void Array::heuristic_c_only(uint16_t *row)
         return;
     }
     
-    // else, try altering the value(s) with the most problems (whatever is currently contributing the least)
+    // else, try altering the value(s) with the most problems (whatever is currently contributing the least);
+    // only the Interactions through the altered column change, so the rest of the row is scored just once
     int32_t cur_max = max_problems; // for comparing to max_problems to see if there is an improvement
+    int32_t *row_problems = new int32_t[num_factors]{0};    // what the helper would score for the row as is
+    add_c_problems(&row_interactions, row_problems, 1);
+    int32_t *other_problems = new int32_t[num_factors]; // the same, without the Interactions through a column
+    std::vector<Interaction*> col_interactions;
     for (uint16_t col = 0; col < num_factors; col++) {  // go find any factors to change
         if (problems[permutation[col]] == max_problems) {   // found a factor to try altering
             int32_t *temp_problems = new int32_t[num_factors]{0};   // will be mutated by helper
+            for (uint16_t f = 0; f < num_factors; f++) other_problems[f] = row_problems[f];
+            col_interactions.clear();
+            build_column_interactions(row, permutation[col], &col_interactions);
+            add_c_problems(&col_interactions, other_problems, -1);
 
             for (uint16_t i = 1; i < factors[permutation[col]]->level; i++) {   // try every possible value
                 row[permutation[col]] = (row[permutation[col]] + 1) % factors[permutation[col]]->level;
-                std::set<Interaction*> new_interactions;    // get the new Interactions
-                build_row_interactions(row, &new_interactions, 0, t, "");
+                col_interactions.clear();   // get the new Interactions through this column
+                build_column_interactions(row, permutation[col], &col_interactions);
 
-                cur_max = heuristic_c_helper(row, &new_interactions, temp_problems);    // test this change
+                for (uint16_t f = 0; f < num_factors; f++) temp_problems[f] += other_problems[f];
+                cur_max = heuristic_c_helper(row, &col_interactions, temp_problems);    // test this change
                 if (cur_max < max_problems) {   // this change improved the score, keep it
                     delete[] problems;
                     delete[] dont_cares_c;
                     delete[] temp_problems;
+                    delete[] row_problems;
+                    delete[] other_problems;
                     return;
                 }
                 cur_max = max_problems; // else this change was no good, reset and continue
@@ -338,66 +386,131 @@ void Array::heuristic_c_only(uint16_t *row)
             row[permutation[col]] = (row[permutation[col]] + 1) % factors[permutation[col]]->level;
         }
     }
+    delete[] row_problems;
+    delete[] other_problems;
 
-    // last resort, start looking for *anything* that is missing
+    // last resort, start looking for *anything* that is missing; a factor is part of a missing Interaction in
+    // the row exactly when it has a nonzero count below, which is kept up to date as columns change
+    uint64_t *missing = new uint64_t[num_factors]{0};   // per factor, uncovered Interactions in the row with it
+    uint64_t total_missing = 0;
+    std::vector<uint32_t> gains;    // per value of a column, uncovered Interactions through it with that value
+    for (Interaction *interaction : row_interactions)
+        if (interaction->rows.size() == 0) {    // the Interaction is not already covered
+            for (Single *s : interaction->singles) missing[s->factor]++;
+            total_missing++;
+        }
     for (uint16_t col = 0; col < num_factors; col++) {  // for all factors
         if (dont_cares_c[permutation[col]] != none) continue;   // no need to check already completed factors
+        // try every possible value, in turn from the one after the current one; with every other column fixed,
+        // how many would be missing for each value is known up front, so only the one kept is applied
+        uint16_t level = factors[permutation[col]]->level;
+        gains.resize(level);
+        column_gains(row, permutation[col], nullptr, gains.data());
+        uint64_t without_col = total_missing - gains[row[permutation[col]]];
         bool improved = false;
-        for (uint16_t i = 0; i < factors[permutation[col]]->level; i++) {   // try every possible value
-            row[permutation[col]] = (row[permutation[col]] + 1) % factors[permutation[col]]->level;
-            std::set<Interaction*> new_interactions;    // get the new Interactions
-            build_row_interactions(row, &new_interactions, 0, t, "");
-
-            improved = false;   // see if the change helped
-            for (Interaction *interaction : new_interactions)
-                if (interaction->rows.size() == 0) {    // the Interaction is not already covered
-                    for (Single *s : interaction->singles) dont_cares_c[s->factor] = c_only;
-                    improved = true;    // note: don't break, we want to set as many dont_cares_c as possible
-                }
-            if (improved) break;    // keep this factor as this value
+        for (uint16_t i = 1; i <= level; i++) {
+            uint16_t val = (row[permutation[col]] + i) % level;
+            improved = without_col + gains[val] > 0;    // see if the change would help
+            if (improved) { // set as many dont_cares_c as possible
+                change_column(row, permutation[col], val, missing, &total_missing);
+                for (uint16_t f = 0; f < num_factors; f++)
+                    if (missing[f] > 0) dont_cares_c[f] = c_only;
+                break;  // keep this factor as this value
+            }
         }
         if (improved) continue; // don't execute the next line
-        row[permutation[col]] = rand() % factors[permutation[col]]->level;  // if not possible to improve
+        uint16_t val = static_cast<uint16_t>(rng.below(level));  // if not possible to improve
+        change_column(row, permutation[col], val, missing, &total_missing);
     }
+    delete[] missing;
     delete[] problems;
     delete[] dont_cares_c;
 }
 
+/* HELPER METHOD: change_column - changes one value of a row, keeping counts of its missing Interactions
+ * - used by heuristic_c_only(); only the Interactions through the column are visited
+ * 
+ * parameters:
+ * - row: integer array representing a row being considered for adding to the array
+ * - col: the column to change
+ * - val: the value to change it to
+ * - missing: per factor, how many uncovered Interactions in the row include it
+ * - total_missing: pointer to how many uncovered Interactions are in the row
+ * 
+ * returns:
+ * - void, but after the method finishes, the row and the counts will reflect the new value
+*/
+void Array::change_column(uint16_t *row, uint16_t col, uint16_t val, uint64_t *missing,
+    uint64_t *total_missing)
+{
+    std::vector<Interaction*> col_interactions;
+    build_column_interactions(row, col, &col_interactions);
+    for (Interaction *interaction : col_interactions)
+        if (interaction->rows.size() == 0) {
+            for (Single *s : interaction->singles) missing[s->factor]--;
+            (*total_missing)--;
+        }
+    row[col] = val;
+    col_interactions.clear();
+    build_column_interactions(row, col, &col_interactions);
+    for (Interaction *interaction : col_interactions)
+        if (interaction->rows.size() == 0) {
+            for (Single *s : interaction->singles) missing[s->factor]++;
+            (*total_missing)++;
+        }
+}
+
 /* HELPER METHOD: heuristic_c_helper - performs redundant work for heuristic_c_only()
  * 
  * parameters:
  * - row: integer array representing a row being considered for adding to the array
- * - row_interactions: set containing all Interactions present in the row
+ * - row_interactions: vector containing the Interactions present in the row that should be scored
  * - problems: pointer to start of array associating each column in the row with a score of sorts
  * 
  * returns:
  * - int representing the largest value in the problems array after scoring
 */
-int32_t Array::heuristic_c_helper(uint16_t *row, std::set<Interaction*> *row_interactions, int32_t *problems)
+int32_t Array::heuristic_c_helper(uint16_t *row, std::vector<Interaction*> *row_interactions,
+    int32_t *problems)
+{
+    add_c_problems(row_interactions, problems, 1);
+
+    // find out what the worst score is among the factors
+    int32_t max_problems = INT32_MIN;   // set max to a huge negative number to start
+    for (uint16_t col = 0; col < num_factors; col++) {
+        if (c_issues[factors[col]->singles[row[col]].id] == 0) continue;   // already completed factor
+        if (problems[col] > max_problems) max_problems = problems[col];
+    }
+    return max_problems;
+}
+
+/* HELPER METHOD: add_c_problems - scores Interactions the way heuristic_c_helper() does
+ * 
+ * parameters:
+ * - row_interactions: vector containing the Interactions to score
+ * - problems: pointer to start of array associating each column in the row with a score of sorts
+ * - sign: 1 to add the Interactions' scores to problems, or -1 to take them back out
+ * 
+ * returns:
+ * - void, but after the method finishes, problems will be updated
+*/
+void Array::add_c_problems(std::vector<Interaction*> *row_interactions, int32_t *problems, int32_t sign)
 {
     for (Interaction *i : *row_interactions) {
         if (i->rows.size() != 0) {  // Interaction is already covered
             bool can_skip = false;  // don't account for Interactions involving already-completed factors
             for (Single *s : i->singles)
-                if (s->c_issues == 0) { // one of the Singles involved in the Interaction is completed
+                if (c_issues[s->id] == 0) { // one of the Singles involved in the Interaction is completed
                     can_skip = true;
                     break;
                 }
             if (can_skip) continue;
             for (Single *s : i->singles) // increment the problems counter for each Single involved
-                problems[s->factor]++;
+                problems[s->factor] += sign;
         } else {    // Interaction not covered; decrement the problems counters instead
-            for (Single *s : i->singles) problems[s->factor]--;
+            for (Single *s : i->singles) problems[s->factor] -= sign;
         }
     }
-
-    // find out what the worst score is among the factors
-    int32_t max_problems = INT32_MIN;   // set max to a huge negative number to start
-    for (uint16_t col = 0; col < num_factors; col++) {
-        if (factors[col]->singles[row[col]]->c_issues == 0) continue;   // already completed factor
-        if (problems[col] > max_problems) max_problems = problems[col];
-    }
-    return max_problems;
 }
 
 /* SUB METHOD: heuristic_l_only - middleweight heuristic that only concerns itself with location
@@ -406,41 +519,40 @@ int32_t Array::heuristic_c_helper(uint16_t *row, std::set<Interaction*> *row_int
  * 
  * parameters:
  * - row: integer array representing a row being considered for adding to the array
- * - l_set: pointer to T set whose location conflicts will be used to pick column values
+ * - l_set: rank of the T set whose location conflicts will be used to pick column values
  * - l_interaction: pointer to Interaction whose Singles' columns should not be altered
  * 
  * returns:
  * - void, but after the method finishes, the row may be modified in an attempt to satisfy more issues
 */
-void Array::heuristic_l_only(uint16_t *row, T* l_set, Interaction *l_interaction)
+void Array::heuristic_l_only(uint16_t *row, uint64_t l_set, Interaction *l_interaction)
 {
     // keep track of which columns should not be modified
     bool *locked_factors = new bool[num_factors]{false};
     for (Single *s : l_interaction->singles) locked_factors[s->factor] = true;
 
-    std::map<std::string, uint64_t> scores; // create and initialize a map of every Single to a scoring
-    for (uint16_t col = 0; col < num_factors; col++)
-        for (uint16_t val = 0; val < factors[col]->level; val++)
-            scores.insert({"f" + std::to_string(col) + "," + std::to_string(val), 0});
+    single_scores.assign(singles.size(), 0);    // reuses the space from the last call
     
-    for (T *conflict : l_set->location_conflicts)   // for every conflicting T set,
-        for (Single *s : conflict->singles) // for every Single in that conflicting set,
-            scores.at(s->to_string())++;    // increase the score of that Single
-
-    // a larger value in the scores map means the Single is involved in more location conflicts
-    for (uint16_t col = 0; col < num_factors; col++) {
-        if (locked_factors[col]) continue;
-        uint16_t best_val = rand() % factors[col]->level;
-        uint64_t best_val_score = UINT64_MAX;
-        for (uint16_t val = 0; val < factors[col]->level; val++) {
-            uint64_t val_score = scores.at("f" + std::to_string(col) + "," + std::to_string(val));
-            if (val_score < best_val_score) {
-                best_val = val;
-                best_val_score = val_score;
-            }
+    std::vector<uint64_t> members(d);
+    uint64_t c = set_class[l_set];
+    if (c == 0) {   // l_set has not occurred yet, so it conflicts with every other T set; instead of visiting
+        // them all, count each Single once per T set containing each of its Interactions, minus l_set itself
+        uint64_t sets_per_interaction = choose(interactions.size() - 1, d - 1);
+        for (Single *s : singles) single_scores[s->id] += sets_per_interaction*interaction_counts[s->id];
+        unrank_set(l_set, members.data());
+        for (uint64_t m : members)
+            for (Single *s : interactions[m]->singles) single_scores[s->id]--;
+    } else
+        for (uint64_t pos = class_start[c]; pos < class_start[c] + class_size[c]; pos++) {
+            uint64_t conflict = set_order[pos]; // for every conflicting T set,
+            if (conflict == l_set) continue;
+            unrank_set(conflict, members.data());
+            for (uint64_t m : members)  // for every Single in that conflicting set,
+                for (Single *s : interactions[m]->singles) single_scores[s->id]++;  // increase its score
         }
-        if (best_val_score != 0) row[col] = best_val;   // else allow it to remain random
-    }
+
+    // a larger score means the Single is involved in more location conflicts
+    choose_least_scored(row, locked_factors);
     delete[] locked_factors;
 }
 
@@ -461,32 +573,45 @@ void Array::heuristic_l_and_d(uint16_t *row, Interaction *locked)
     bool *locked_factors = new bool[num_factors]{false};
     for (Single *s : locked->singles) locked_factors[s->factor] = true;
 
-    std::map<std::string, uint64_t> scores; // create and initialize a map of every Single to a scoring
-    for (uint16_t col = 0; col < num_factors; col++)
-        for (uint16_t val = 0; val < factors[col]->level; val++)
-            scores.insert({"f" + std::to_string(col) + "," + std::to_string(val), 0});
+    single_scores.assign(singles.size(), 0);    // reuses the space from the last call
     
-    for (auto &kv : locked->deltas) {   // for every t set from which the locked interaction needs separation,
-        if (kv.second >= delta) continue;   // (skip if separation is already sufficient)
-        for (Single *s : kv.first->singles)                 // for every Single in that set,
-            scores.at(s->to_string()) += delta - kv.second; // increase the score of that Single
+    std::vector<uint64_t> members(d), unseparated;
+    unseparated_sets(locked, &unseparated);
+    for (uint64_t rank : unseparated) { // for every t set from which the locked interaction needs separation,
+        unrank_set(rank, members.data());
+        for (uint64_t m : members)  // for every Single in that set,
+            for (Single *s : interactions[m]->singles)  // increase the score of that Single
+                single_scores[s->id] += delta - separation(locked, rank);
     }
 
-    // a larger value in the scores map means the Single is involved in more sets that need separation
+    // a larger score means the Single is involved in more sets that need separation
+    choose_least_scored(row, locked_factors);
+    delete[] locked_factors;
+}
+
+/* HELPER METHOD: choose_least_scored - sets each column to the value whose Single has the lowest score
+ * - used by heuristic_l_only() and heuristic_l_and_d() once they have filled out single_scores
+ * - the first value with the lowest score is taken, unless that score is 0, in which case no value of the
+ *   column is involved in anything and the column is left as it was
+ * 
+ * parameters:
+ * - row: integer array representing a row being considered for adding to the array
+ * - locked_factors: per column, whether it should not be altered
+ * 
+ * returns:
+ * - void, but after the method finishes, the unlocked columns of the row will be set
+*/
+void Array::choose_least_scored(uint16_t *row, bool *locked_factors)
+{
     for (uint16_t col = 0; col < num_factors; col++) {
         if (locked_factors[col]) continue;
-        uint16_t best_val = rand() % factors[col]->level;
-        uint64_t best_val_score = UINT64_MAX;
-        for (uint16_t val = 0; val < factors[col]->level; val++) {
-            uint64_t val_score = scores.at("f" + std::to_string(col) + "," + std::to_string(val));
-            if (val_score < best_val_score) {
-                best_val = val;
-                best_val_score = val_score;
-            }
-        }
-        if (best_val_score != 0) row[col] = best_val;   // else allow it to remain random
+        // only kept if every score is UINT64_MAX
+        uint16_t best_val = static_cast<uint16_t>(rng.below(factors[col]->level));
+        const uint64_t *scores = &single_scores[factors[col]->singles[0].id];  // its ids are consecutive
+        uint16_t least = least_index(scores, factors[col]->level);
+        if (scores[least] != UINT64_MAX) best_val = least;
+        if (scores[least] != 0) row[col] = best_val;    // else allow it to remain random
     }
-    delete[] locked_factors;
 }
 
 /* SUB METHOD: heuristic_all - heavyweight heuristic that tries to solve the most problems possible
@@ -504,51 +629,19 @@ void Array::heuristic_l_and_d(uint16_t *row, Interaction *locked)
 */
 bool Array::heuristic_all(uint16_t *row)
 {
-    // check if there is even enough memory to use this heuristic
-    if (!probe_memory_for_threads()) return false;
-
-    // get scores for all relevant possible rows
-    std::vector<std::thread*> threads;
-    heuristic_all_helper(row, 0, &threads);
-    for (std::thread *cur_thread : threads) {
-        cur_thread->join();
-        delete cur_thread;
-    }
-
-    // inspect the scores for the best one(s)
-    uint64_t best_score = 0;
-    min_positive_score = UINT64_MAX;
-    std::vector<std::string> best_rows; // there could be ties for the best
-    for (auto &kv : row_scores) {
-        if (kv.second >= best_score) {  // it was better or it tied
-            if (kv.second > best_score) {   // for an even better choice, can stop tracking the previous best
-                best_score = kv.second;
-                best_rows.clear();
-            }
-            best_rows.push_back(kv.first);  // whether it was better or only a tie, keep track of this row
-        }
-        if (kv.second < min_positive_score) min_positive_score = kv.second;
-    }
-    if (min_positive_score == UINT64_MAX) min_positive_score = 0;   // shouldn't ever happen
-    if (min_positive_score == 0) min_positive_score = 1;
-
-    // choose the row that scored the best (for ties, choose randomly from among those tied for the best)
-    uint64_t choice = static_cast<uint64_t>(rand()) % best_rows.size();  // for breaking ties randomly
-    std::stringstream choice_ss = std::stringstream(best_rows.at(choice));
-    for (uint16_t col = 0; col < num_factors; col++)
-        choice_ss >> row[col];
-    
-    row_scores[best_rows.at(choice)] = delta <= 1 ? 0 : min_positive_score - 1;
-    return true;
+    return heuristic_all(row, nullptr);
 }
 
 /* SUB METHOD: heuristic_all - heavyweight heuristic that tries to solve the most problems possible
  * - overloaded; this version takes a locked Interaction and chooses only from rows containing it
  *  --> does less work than the original version, but may not find the row that would have scored best
+ * - the search is a branch and bound: a partial row whose bound (see build_score_bounds()) falls below the
+ *   best score seen so far cannot lead to the best row, so none of its completions are scored
  * 
  * parameters:
  * - row: integer array representing a row up for consideration for appending to the array
  * - locked: pointer to Interaction whose Singles' columns should not be altered
+ *  --> pass nullptr to choose from all rows
  * 
  * returns:
  * - bool representing whether the method succeeded
@@ -556,41 +649,40 @@ bool Array::heuristic_all(uint16_t *row)
 bool Array::heuristic_all(uint16_t *row, Interaction *locked)
 {
     // check if there is even enough memory to use this heuristic
-    if (!probe_memory_for_threads()) return false;
-
-    // get scores for all relevant possible rows
-    std::vector<std::thread*> threads;
-    std::map<std::string, uint64_t> local_scores;
-    heuristic_all_helper(row, 0, &threads, locked, &local_scores);
-    for (std::thread *cur_thread : threads) {
-        cur_thread->join();
-        delete cur_thread;
-    }
+    if (!start_heuristic_all()) return false;
 
-    // inspect the scores for the best one(s)
-    uint64_t best_score = 0;
-    std::vector<std::string> best_rows; // there could be ties for the best
-    for (auto &kv : local_scores) {
-        if (kv.second >= best_score) {  // it was better or it tied
-            if (kv.second > best_score) {   // for an even better choice, can stop tracking the previous best
-                best_score = kv.second;
-                best_rows.clear();
-            }
-            best_rows.push_back(kv.first);  // whether it was better or only a tie, keep track of this row
-        }
-    }
+    // get scores for all possible rows that could be the best
+    best_rows.clear();
+    best_row_values.clear();
+    if (score_cache) score_cache->tick();
+    build_score_bounds(row, locked);
+    heuristic_all_helper(row, 0, 0, 0, locked);
+    pool->wait();
 
     // choose the row that scored the best (for ties, choose randomly from among those tied for the best)
-    uint64_t choice = static_cast<uint64_t>(rand()) % best_rows.size();  // for breaking ties randomly
-    std::stringstream choice_ss = std::stringstream(best_rows.at(choice));
-    for (uint16_t col = 0; col < num_factors; col++)
-        choice_ss >> row[col];
+    if (!row_radix.empty()) {
+        std::sort(best_rows.begin(), best_rows.end());  // the order ties were found in depends on the threads
+        uint64_t choice = best_rows.at(rng.below(best_rows.size()));
+        for (uint16_t col = 0; col < num_factors; col++)
+            row[col] = static_cast<uint16_t>(choice / row_radix[col] % factors[col]->level);
+        return true;
+    }
+    std::vector<const uint16_t*> tied;  // without keys, the rows are put in the same order by their values
+    for (uint64_t idx = 0; idx < best_row_values.size(); idx += num_factors)
+        tied.push_back(&best_row_values[idx]);
+    std::sort(tied.begin(), tied.end(), [this](const uint16_t *a, const uint16_t *b) {
+        return std::lexicographical_compare(a, a + num_factors, b, b + num_factors);
+    });
+    const uint16_t *choice = tied.at(rng.below(tied.size()));
+    for (uint16_t col = 0; col < num_factors; col++) row[col] = choice[col];
     return true;
 }
 
 /* HELPER METHOD: heuristic_all_helper - performs top-down recursive logic for heuristic_all()
  * - heuristic_all() does the auxilary work to start the recursion, and handle the result
  * - this method uses recursion to form all possible combinations; its base case scores a given combination
+ *  --> a combination is abandoned as soon as its bound shows it cannot beat the best score seen so far;
+ *      since a row that ties the best is never abandoned, every row tied for the best still gets a score
  * 
  * parameters:
  * - row: integer array representing a row being considered for adding to the array
@@ -598,100 +690,72 @@ bool Array::heuristic_all(uint16_t *row, Interaction *locked)
  *  --> overhead caller should pass 0 to this method initially
  *  --> value should increment by 1 with each recursive call
  *  --> triggers the base case when value is equal to the total number of columns
- * - threads: pointer to vector of pointers to threads, needed so caller can join threads later
- *  --> overhead caller should pass the address of an empty vector to this method initially
- *  --> a separate thread should be started for each row inspected by the base case
+ * - bound: sum of the single_bounds of the values chosen so far for the columns before cur_col
+ *  --> overhead caller should pass 0 to this method initially
+ * - key: sum of value*row_radix[column] for the values chosen so far for the columns before cur_col
+ *  --> overhead caller should pass 0 to this method initially
+ *  --> stays 0 if row_radix is empty
  * - locked: pointer to Interaction whose Singles' columns should not be altered
- *  --> has a default value of nullptr, meaning all rows will be scored by default
- * - local_scores: pointer to map in which scoring resultsshould be stored
- *  --> has a default value of nullptr; when nullptr, scores are stored into memoized field in Array.h
+ *  --> pass nullptr to have all rows considered
  * 
  * returns:
- * - void, but scores will be modified to contain all the rows inspected and their scores
+ * - void, but every row inspected will have been handed to the pool for scoring, unless its score was cached
+ *  --> caller must wait on the pool before best_rows will be complete
 */
-void Array::heuristic_all_helper(uint16_t *row, uint16_t cur_col, std::vector<std::thread*> *threads,
-    Interaction *locked, std::map<std::string, uint64_t> *local_scores)
+void Array::heuristic_all_helper(uint16_t *row, uint16_t cur_col, uint64_t bound, uint64_t key,
+    Interaction *locked)
 {
+    if (bound + remaining_bounds[cur_col] < best_row_score) return; // no completion of this row can win
+
     // base case: row represents a unique combination and is ready for scoring
     if (cur_col == num_factors) {
-        std::string row_str = std::to_string(row[0]); // string representation of the row
-        for (uint16_t col = 1; col < num_factors; col++) row_str += ' ' + std::to_string(row[col]);
-        if (just_switched_heuristics && heuristic_in_use == all) row_scores[row_str] += UINT64_MAX;
-        if (heuristic_in_use == all && row_scores[row_str] < min_positive_score) return;
-        uint16_t *row_copy = new uint16_t[num_factors]; // must be deleted by thread later
-        for (uint16_t col = 0; col < num_factors; col++) row_copy[col] = row[col];
-        if (threads->size() == max_threads) {
-            for (std::thread *cur_thread : *threads) {
-                cur_thread->join();
-                delete cur_thread;
-            }
-            threads->clear();
-        }
-        std::thread *new_thread = new std::thread(&Array::heuristic_all_scorer, this, row_copy, row_str, local_scores);
-        if (!new_thread) {
-            for (std::thread *cur_thread : *threads) {
-                cur_thread->join();
-                delete cur_thread;
-            }
-            threads->clear();
-            new_thread = new std::thread(&Array::heuristic_all_scorer, this, row_copy, row_str, local_scores);
+        uint64_t row_score;     // a cached score holds if nothing it depends on has changed since
+        if (score_cache && score_cache->lookup(key, &row_score)) {
+            record_row_score(key, row_score, row);
+            return;
         }
-        
-        threads->push_back(new_thread); // add the thread's reference to the threads vector
+        uint16_t *row_copy = new uint16_t[num_factors]; // must be deleted by the scorer later
+        for (uint16_t col = 0; col < num_factors; col++) row_copy[col] = row[col];
+        pool->submit([this, row_copy, key]() {  // blocks while the workers catch up
+            heuristic_all_scorer(row_copy, key);
+        });
         return;
     }
 
     // recursive case: need to introduce another loop for the next factor
+    Factor *f = factors[permutation[cur_col]];
+    uint64_t place = row_radix.empty() ? 0 : row_radix[f->id];
     if (locked) // if not nullptr, skip modifying this column if it is locked
         for (Single *s : locked->singles)
-            if (s->factor == permutation[cur_col]) {
-                heuristic_all_helper(row, cur_col+1, threads, locked, local_scores);
+            if (s->factor == f->id) {
+                heuristic_all_helper(row, cur_col+1, bound + single_bounds[s->id], key + s->value*place,
+                    locked);
                 return;
             }
-    for (uint16_t offset = 0; offset < factors[permutation[cur_col]]->level; offset++) {
-        uint16_t temp = row[permutation[cur_col]];
-        row[permutation[cur_col]] = (row[permutation[cur_col]] + offset) %
-            factors[permutation[cur_col]]->level;   // try every value for this factor
-        heuristic_all_helper(row, cur_col+1, threads, locked, local_scores);
-        row[permutation[cur_col]] = temp;
+    uint16_t temp = row[f->id];
+    for (uint16_t k = 0; k < f->level; k++) {   // try every value for this factor, most promising first
+        Single *s = &f->singles[value_order[f->singles[0].id + k]];
+        if (bound + single_bounds[s->id] + remaining_bounds[cur_col+1] < best_row_score) break; // nor the rest
+        row[f->id] = s->value;
+        heuristic_all_helper(row, cur_col+1, bound + single_bounds[s->id], key + s->value*place, locked);
     }
+    row[f->id] = temp;
 }
 
 /* HELPER METHOD: heuristic_all_scorer - scores a given row by testing what would change if it was added
- * - should be called in a unique thread
- * - heuristic_all() should await the termination of all sub threads before inspecting scores
+ * - should be run as a task on the pool
+ * - heuristic_all() should wait on the pool before inspecting best_rows
  * 
  * parameters:
- * - row: integer array representing a row needing scoring
- *  --> pass nullptr when probing whether there is enough memory to start threads
- * - row_str: string representation of the row
- *  --> pass "dummy" when probing whether there is enough memory to start threads
- * - local_scores: pointer to map in which scoring resultsshould be stored
- *  --> has a default value of nullptr; when nullptr, scores are stored into memoized field in Array.h
+ * - row: integer array representing a row needing scoring; it is deleted by this method
+ * - key: the row's key, the sum of value*row_radix[column] over its columns
  * 
  * returns:
- * - void, but scores may be updates
+ * - void, but the score will be cached and recorded (see record_row_score())
 */
-void Array::heuristic_all_scorer(uint16_t *row, std::string row_str,
-    std::map<std::string, uint64_t> *local_scores)
+void Array::heuristic_all_scorer(uint16_t *row, uint64_t key)
 {
-    if (row_str.compare("dummy") == 0) return;  // see method header for explanation
-
-    // current thread will work with unique copies of the data structures being modified
-    Array *copy = nullptr;
-    while (!copy) copy = clone();   // if out of memory, try waiting for other threads to finish
-    copy->update_array(row, false); // see how all scores, etc., would change
-
-    // define the row score to be the combination of net changes below, weighted by importance
-    uint64_t row_score = 0;
-    for (Single *this_s : singles) { // improve the score based on individual Single improvement
-        Single *copy_s = copy->single_map.at(this_s->to_string());
-        uint64_t weight = static_cast<uint64_t>(factors[this_s->factor]->level);    // higher level factors hold more weight
-        row_score += (this_s->c_issues - copy_s->c_issues)*weight/3;
-        row_score += (this_s->l_issues - copy_s->l_issues)*weight/2;
-        row_score += (this_s->d_issues - copy_s->d_issues)*weight;
-    }
-    delete copy;
+    uint64_t row_score = score_row(row);    // see how all scores, etc., would change
 
     if (debug == d_on) {
         std::stringstream thread_output;
@@ -702,58 +766,270 @@ void Array::heuristic_all_scorer(uint16_t *row, std::string row_str,
         printf("%s", thread_output.str().c_str());
         scores_mutex.unlock();
     }
+
+    // the score depends on the row's own Interactions, which invalidate_cached_scores() goes by
+    if (score_cache) {
+        std::vector<Interaction*> row_interactions;
+        build_row_interactions(row, &row_interactions);
+        std::vector<uint64_t> tags;
+        for (Interaction *i : row_interactions) tags.push_back(i->rank);
+        score_cache->store(key, row_score, tags);
+    }
+    record_row_score(key, row_score, row);
     delete[] row;
+}
 
-    // need to add result to data structure containing all thread's results; use mutex for thread safety
-    if (local_scores) { // if not nullptr, do not permanently memoize these scores, simply store to local map
-        scores_mutex.lock();
-        (*local_scores)[row_str] = row_score;
-        scores_mutex.unlock();
-    } else {
-        scores_mutex.lock();
-        row_scores[row_str] = row_score;
-        scores_mutex.unlock();
+/* HELPER METHOD: record_row_score - keeps track of the rows tied for the best score in heuristic_all()
+ * - safe to call from any thread
+ * 
+ * parameters:
+ * - key: the row's key, the sum of value*row_radix[column] over its columns
+ * - row_score: the row's score
+ * - row: the row's values, which are only kept if row_radix is empty
+ * 
+ * returns:
+ * - void, but best_rows (or best_row_values) and best_row_score will be updated if the row beat or tied the
+ *   best so far
+*/
+void Array::record_row_score(uint64_t key, uint64_t row_score, const uint16_t *row)
+{
+    std::lock_guard<std::mutex> guard(scores_mutex);
+    if (row_score < best_row_score) return;
+    if (row_score > best_row_score) {   // for an even better choice, can stop tracking the previous best
+        best_row_score = row_score;     // only ever raised while holding the mutex
+        best_rows.clear();
+        best_row_values.clear();
+    }
+    // whether it was better or only a tie, keep track of this row
+    if (row_radix.empty()) best_row_values.insert(best_row_values.end(), row, row + num_factors);
+    else best_rows.push_back(key);
+}
+
+/* HELPER METHOD: build_score_bounds - prepares the bounds that heuristic_all() uses to skip hopeless rows
+ * - a row's score is a sum over its Singles, and each Single's part of it can be bounded on its own:
+ *  --> coverage: for every tuple of columns including the Single's, at most 1 Interaction is covered, and
+ *      only if some uncovered Interaction in that tuple contains the Single
+ *  --> detection: likewise, at most one Interaction per tuple, each relieving at most the T sets from which
+ *      it is not yet separated enough; so the tuple's largest such count among those containing the Single
+ *  --> location: a T set in the row needs only one of its Interactions in the row, so the relief can land on
+ *      Singles outside the row too, as can the relief of the T sets left behind when a class splits (which
+ *      in total is never more than that of the T sets in the row); so the row as a whole is allowed, at the
+ *      heaviest weight of any Single, twice the location issues of every T set containing an Interaction in
+ *      the row, once for each of its d*t Singles, and that allowance is split among the Singles in the row
+ * - the weights are the same as in score_row(), so the bound of a row is never below its score
+ * 
+ * parameters:
+ * - row: integer array representing the row heuristic_all() starts from; only locked columns are read
+ * - locked: pointer to Interaction whose Singles' columns will not be altered, or nullptr
+ * 
+ * returns:
+ * - void, but after the method finishes, single_bounds, value_order, and remaining_bounds will be ready,
+ *   and best_row_score will be reset
+*/
+void Array::build_score_bounds(uint16_t *row, Interaction *locked)
+{
+    // per Single, its coverage, location, and detection bounds (at 3*id, 3*id+1, 3*id+2), and the largest
+    // of each seen so far among the Interactions containing it in the current tuple of columns
+    std::vector<uint64_t> bound(3*singles.size(), 0), slot(3*singles.size(), 0);
+    std::vector<uint64_t> l_totals(interactions.size(), 0); // per Interaction, location issues it can relieve
+    if (p != c_only && !is_locating) location_totals(&l_totals);
+    for (uint64_t tuple = 0; tuple < tuple_offsets.size(); tuple++) {
+        uint64_t start = tuple_offsets[tuple];
+        uint64_t end = tuple + 1 < tuple_offsets.size() ? tuple_offsets[tuple + 1] : interactions.size();
+        for (uint64_t rank = start; rank < end; rank++) {
+            uint64_t unsaturated = 0;   // T sets from which this Interaction is not yet separated enough
+            if (p == all && !is_detectable[rank]) {
+                const uint8_t *sep = &separations[rank*num_sets];
+                const uint64_t *active = &active_blocks[rank*active_words];
+                for (uint64_t word = 0; word < active_words; word++)
+                    for (uint64_t bits = active[word]; bits != 0; bits &= bits - 1) {
+                        uint64_t block = word*64 + static_cast<uint64_t>(__builtin_ctzll(bits));
+                        for (uint64_t set = block*64; set < num_sets && set < (block + 1)*64; set++)
+                            if (sep[set] < delta) unsaturated++;
+                    }
+            }
+            for (Single *s : interactions[rank]->singles) {
+                uint64_t *cur = &slot[3*s->id];
+                if (!is_covered[rank]) cur[0] = 1;
+                if (l_totals[rank] > cur[1]) cur[1] = l_totals[rank];
+                if (unsaturated > cur[2]) cur[2] = unsaturated;
+            }
+        }
+        for (Single *first : interactions[start]->singles) {    // every value of every column in the tuple
+            Factor *f = factors[first->factor];
+            for (uint16_t val = 0; val < f->level; val++) {
+                uint64_t idx = 3*static_cast<uint64_t>(f->singles[val].id);
+                for (uint64_t kind = idx; kind < idx + 3; kind++) {
+                    bound[kind] += slot[kind];
+                    slot[kind] = 0;
+                }
+            }
+        }
+    }
+
+    uint64_t heaviest = 0;  // the heaviest weight of any Single
+    for (uint16_t col = 0; col < num_factors; col++)
+        if (factors[col]->level > heaviest) heaviest = factors[col]->level;
+    single_bounds.assign(singles.size(), 0);
+    for (Single *s : singles) {
+        uint64_t weight = static_cast<uint64_t>(factors[s->factor]->level); // same weights as score_row()
+        const uint64_t *cur = &bound[3*s->id];
+        single_bounds[s->id] = cur[0]*weight/3 + cur[1]*heaviest*d + cur[2]*weight;
     }
+
+    // order each factor's values from most to least promising, so the search can stop at the first hopeless one
+    value_order.assign(singles.size(), 0);
+    for (uint16_t col = 0; col < num_factors; col++) {
+        uint16_t *order = &value_order[factors[col]->singles[0].id];
+        for (uint16_t val = 0; val < factors[col]->level; val++) order[val] = val;
+        const uint64_t *bounds = &single_bounds[factors[col]->singles[0].id];
+        std::stable_sort(order, order + factors[col]->level,
+            [bounds](uint16_t a, uint16_t b) { return bounds[a] > bounds[b]; });
+    }
+
+    // the most each suffix of columns (in the current permutation) could add to a row's score
+    remaining_bounds.assign(num_factors + 1, 0);
+    for (uint16_t col = num_factors; col > 0; col--) {
+        Factor *f = factors[permutation[col - 1]];
+        uint64_t most = single_bounds[f->singles[value_order[f->singles[0].id]].id];
+        if (locked)
+            for (Single *s : locked->singles)
+                if (s->factor == f->id) most = single_bounds[f->singles[row[f->id]].id];
+        remaining_bounds[col - 1] = remaining_bounds[col] + most;
+    }
+    best_row_score = 0;
 }
 
-/* UTILITY METHOD: probe_memory_for_threads - checks if there is enough memory for heuristic_all() to execute
+/* HELPER METHOD: score_row - scores a given row by working out what would change if it was added
+ * - this is a dry run of update_scores(): it reads the current state without modifying or copying any of
+ *   it, so many threads may call it at once for different rows
+ * 
+ * parameters:
+ * - row: integer array representing a row needing scoring
  * 
  * returns:
- * - bool representing whether there is enough memory that heuristic_all() could work
+ * - the combination of the net changes in issues of every Single, weighted by importance
 */
-bool Array::probe_memory_for_threads()
+uint64_t Array::score_row(uint16_t *row)
 {
-    Array *copy = clone();  // this operation will have to be performed by at least one thread at a time
-    if (!copy) return false;
+    // how much the issues of each Single (indexed by id) would go down
+    std::vector<uint64_t> c_relief(singles.size(), 0), l_relief(singles.size(), 0), d_relief(singles.size(), 0);
 
-    uint16_t *row_copy = new uint16_t[num_factors]; // same as above
-    if (!row_copy) {
-        delete copy;
-        return false;
+    std::vector<Interaction*> row_interactions; // all Interactions that would occur in this row
+    build_row_interactions(row, &row_interactions);
+    std::vector<uint64_t> row_sets; // ranks of all T sets that would occur in this row
+    if (p != c_only)
+        for (Interaction *i : row_interactions) sets_containing(i->rank, &row_sets);
+    std::sort(row_sets.begin(), row_sets.end());
+    row_sets.erase(std::unique(row_sets.begin(), row_sets.end()), row_sets.end());
+
+    // coverage and detection are associated with interactions
+    std::vector<uint64_t> row_blocks, row_block_bits;   // the T sets in this row, 64 ranks at a time
+    if (p == all)
+        for (uint64_t rank : row_sets) {
+            if (row_blocks.empty() || row_blocks.back() != rank >> 6) {
+                row_blocks.push_back(rank >> 6);
+                row_block_bits.push_back(0);
+            }
+            row_block_bits.back() |= static_cast<uint64_t>(1) << (rank & 63);
+        }
+    for (Interaction *i : row_interactions) {
+        if (!is_covered[i->rank])   // this Interaction would become covered
+            for (Single *s : i->singles) c_relief[s->id]++;
+        if (p != all || is_detectable[i->rank]) continue;
+
+        // every T set not in this row from which separation is still insufficient would gain a row of it
+        const uint8_t *sep = &separations[i->rank*num_sets];
+        const uint64_t *active = &active_blocks[i->rank*active_words];
+        uint64_t solved = 0, idx = 0;
+        for (uint64_t word = 0; word < active_words; word++)
+            for (uint64_t bits = active[word]; bits != 0; bits &= bits - 1) {
+                uint64_t block = word*64 + static_cast<uint64_t>(__builtin_ctzll(bits));
+                while (idx < row_blocks.size() && row_blocks[idx] < block) idx++;
+                uint64_t in_row = idx < row_blocks.size() && row_blocks[idx] == block ? row_block_bits[idx] : 0;
+                for (uint64_t rank = block*64; rank < num_sets && rank < (block + 1)*64; rank++)
+                    if (sep[rank] < delta && !((in_row >> (rank & 63)) & 1)) solved++;
+            }
+        for (Single *s : i->singles) d_relief[s->id] += solved;
     }
 
-    // also need to check if there is enough memory for at least one thread that would be using a copy
-    std::vector<std::thread*> threads;
-    for (uint32_t count = 0; count < max_threads; count++) {
-        std::thread *temp = new std::thread(&Array::heuristic_all_scorer, this, nullptr, "dummy", nullptr);
-        if (!temp) {
-            delete copy;
-            delete[] row_copy;
-            for (std::thread *thread : threads) {
-                thread->join();
-                delete thread;
+    // location is associated with sets of interactions; see update_scores() for how the classes would split
+    if (p != c_only && !is_locating) {
+        std::vector<std::pair<uint64_t, uint64_t>> touched;  // (class, rank) of every T set in this row
+        for (uint64_t rank : row_sets) touched.push_back({set_class[rank], rank});
+        std::sort(touched.begin(), touched.end());
+        std::vector<uint64_t> members(d);
+        for (uint64_t start = 0, end = 0; start < touched.size(); start = end) {
+            uint64_t c = touched[start].first;
+            while (end < touched.size() && touched[end].first == c) end++;
+            uint64_t in_row = end - start, size = class_size[c];
+            if (c != 0 && in_row == size) continue; // all the sets would still be in the same rows
+            for (uint64_t idx = start; idx < end; idx++) {
+                unrank_set(touched[idx].second, members.data());
+                for (uint64_t m : members)
+                    for (Single *s : interactions[m]->singles)
+                        l_relief[s->id] += c == 0 ? num_sets - (in_row - 1) : size - in_row;
+            }
+            if (c == 0) continue;   // T sets that still have not occurred would not change
+            for (uint64_t pos = class_start[c]; pos < class_start[c] + size; pos++) {
+                uint64_t rank = set_order[pos];
+                if (std::binary_search(row_sets.begin(), row_sets.end(), rank)) continue;
+                unrank_set(rank, members.data());
+                for (uint64_t m : members)
+                    for (Single *s : interactions[m]->singles) l_relief[s->id] += in_row;
             }
-            return false;
         }
-        threads.push_back(temp);
     }
 
-    // if made it to this point, success
-    delete copy;
-    delete[] row_copy;
-    for (std::thread *thread : threads) {
-        thread->join();
-        delete thread;
+    // define the row score to be the combination of net changes below, weighted by importance
+    uint64_t row_score = 0;
+    for (Single *s : singles) { // improve the score based on individual Single improvement
+        uint64_t weight = static_cast<uint64_t>(factors[s->factor]->level); // higher levels hold more weight
+        row_score += c_relief[s->id]*weight/3;
+        row_score += l_relief[s->id]*weight/2;
+        row_score += d_relief[s->id]*weight;
+    }
+    return row_score;
+}
+
+/* UTILITY METHOD: start_heuristic_all - makes what heuristic_all() needs: the workers that score rows with
+ *   it, and the cache that keeps their scores from one call to the next
+ * - these are made only once, the first time this is called, and then kept for the Array's lifetime
+ * 
+ * returns:
+ * - bool representing whether they are ready, which fails only when the system is out of resources
+ *  --> no score cache is made when there are too many possible rows to give each a key
+*/
+bool Array::start_heuristic_all()
+{
+    if (!start_pool()) return false;
+    if (score_cache || row_radix.empty()) return true;  // rows without keys cannot be cached
+    try {
+        score_cache = new ScoreCache(score_cache_bytes, interactions.size(), tuple_offsets.size());
+    } catch (const std::bad_alloc &e) {
+        return false;
     }
     return true;
-}
\ No newline at end of file
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+/* HELPER METHOD: least_index - finds the first of the smallest values in a short run
+ * - the minimum is found first, in a loop without branches that the compiler can turn into vector
+ *   instructions where the target has them, and then its first occurrence
+ * 
+ * parameters:
+ * - values: pointer to the first value
+ * - count: number of values, at least 1
+ * 
+ * returns:
+ * - the lowest index whose value is the smallest
+*/
+static uint16_t least_index(const uint64_t *values, uint16_t count)
+{
+    uint64_t least = values[0];
+    for (uint16_t idx = 1; idx < count; idx++) least = values[idx] < least ? values[idx] : least;
+    uint16_t idx = 0;
+    while (values[idx] != least) idx++;
+    return idx;
+}
@@ -0,0 +1,124 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the CoverageKernel class declared in kernel.h,  |
+| along with the implementations it chooses between. The vector implementations add each run into a        |
+| register of byte counters, which can take 255 runs before any of them could overflow; every 255 runs, the |
+| counters are moved out into the wider sums. Only x86 processors get the vector implementations.           |
+|===========================================================================================================|
+*/
+
+#include "kernel.h"
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// method forward declarations
+static void sum_runs_scalar(const uint8_t *flags, const uint64_t *starts, uint64_t runs, uint16_t width,
+    uint32_t *sums);
+#if defined(__x86_64__) || defined(__i386__)
+static void sum_runs_sse2(const uint8_t *flags, const uint64_t *starts, uint64_t runs, uint16_t width,
+    uint32_t *sums);
+static void sum_runs_avx2(const uint8_t *flags, const uint64_t *starts, uint64_t runs, uint16_t width,
+    uint32_t *sums);
+#endif
+
+const uint64_t CoverageKernel::PADDING;
+
+/* CONSTRUCTOR - initializes the object
+ * - picks the widest implementation the processor supports
+*/
+CoverageKernel::CoverageKernel() : sum(sum_runs_scalar), sum_name("scalar")
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        sum = sum_runs_avx2;
+        sum_name = "avx2";
+    } else if (__builtin_cpu_supports("sse2")) {
+        sum = sum_runs_sse2;
+        sum_name = "sse2";
+    }
+#endif
+}
+
+/* UTILITY METHOD: sum_runs - adds up runs of flags position by position
+ *
+ * parameters:
+ * - flags: the table the runs are in; every flag must be 0 or 1, and the table must be followed by at least
+ *   PADDING readable bytes
+ * - starts: index into flags at which each run starts
+ * - runs: number of runs
+ * - width: number of flags in each run
+ * - sums: pointer to the width counts to add to; sums[v] goes up by how many runs have a 1 at position v
+*/
+void CoverageKernel::sum_runs(const uint8_t *flags, const uint64_t *starts, uint64_t runs, uint16_t width,
+    uint32_t *sums) const
+{
+    sum(flags, starts, runs, width, sums);
+}
+
+/* UTILITY METHOD: name - gets the name of the chosen implementation, for debug output
+*/
+const char *CoverageKernel::name() const
+{
+    return sum_name;
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+/* HELPER METHOD: sum_runs_scalar - the plain implementation of CoverageKernel::sum_runs()
+*/
+static void sum_runs_scalar(const uint8_t *flags, const uint64_t *starts, uint64_t runs, uint16_t width,
+    uint32_t *sums)
+{
+    for (uint64_t run = 0; run < runs; run++) {
+        const uint8_t *first = flags + starts[run];
+        for (uint16_t v = 0; v < width; v++) sums[v] += first[v];
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/* HELPER METHOD: sum_runs_sse2 - the implementation of CoverageKernel::sum_runs() for SSE2, 16 flags at once
+*/
+static void sum_runs_sse2(const uint8_t *flags, const uint64_t *starts, uint64_t runs, uint16_t width,
+    uint32_t *sums)
+{
+    alignas(16) uint8_t counts[16];
+    for (uint16_t lane = 0; lane < width; lane += 16) {
+        uint16_t used = static_cast<uint16_t>(std::min(16, width - lane));  // lanes past width are ignored
+        for (uint64_t run = 0; run < runs;) {
+            uint64_t batch_end = std::min(runs, run + 255);
+            __m128i acc = _mm_setzero_si128();
+            for (; run < batch_end; run++)
+                acc = _mm_add_epi8(acc,
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(flags + starts[run] + lane)));
+            _mm_store_si128(reinterpret_cast<__m128i*>(counts), acc);
+            for (uint16_t v = 0; v < used; v++) sums[lane + v] += counts[v];
+        }
+    }
+}
+
+/* HELPER METHOD: sum_runs_avx2 - the implementation of CoverageKernel::sum_runs() for AVX2, 32 flags at once
+*/
+__attribute__((target("avx2")))
+static void sum_runs_avx2(const uint8_t *flags, const uint64_t *starts, uint64_t runs, uint16_t width,
+    uint32_t *sums)
+{
+    alignas(32) uint8_t counts[32];
+    for (uint16_t lane = 0; lane < width; lane += 32) {
+        uint16_t used = static_cast<uint16_t>(std::min(32, width - lane));  // lanes past width are ignored
+        for (uint64_t run = 0; run < runs;) {
+            uint64_t batch_end = std::min(runs, run + 255);
+            __m256i acc = _mm256_setzero_si256();
+            for (; run < batch_end; run++)
+                acc = _mm256_add_epi8(acc,
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(flags + starts[run] + lane)));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(counts), acc);
+            for (uint16_t v = 0; v < used; v++) sums[lane + v] += counts[v];
+        }
+    }
+}
+#endif
@@ -0,0 +1,86 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the MappedFile class declared in mapped.h.      |
+|===========================================================================================================|
+*/
+
+#include "mapped.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* UTILITY METHOD: open - makes the bytes of a file available through data() and size()
+ * - a regular file with anything in it is mapped; anything else is read in full
+ *
+ * parameters:
+ * - filename: path of the file
+ *
+ * returns:
+ * - true if the whole file is available, false if it could not be opened or read
+*/
+bool MappedFile::open(const std::string &filename)
+{
+    close();
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+        void *pages = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pages != MAP_FAILED) {
+            mapping = pages;
+            length = static_cast<uint64_t>(info.st_size);
+            madvise(mapping, length, MADV_SEQUENTIAL);
+            ::close(fd);
+            return true;
+        }
+    }
+
+    // could not be mapped, so read it all instead
+    char chunk[1 << 16];
+    ssize_t got;
+    while ((got = read(fd, chunk, sizeof(chunk))) > 0) buffer.insert(buffer.end(), chunk, chunk + got);
+    ::close(fd);
+    if (got < 0) {
+        buffer.clear();
+        return false;
+    }
+    length = buffer.size();
+    return true;
+}
+
+/* UTILITY METHOD: data - gets the bytes of the file
+ *
+ * returns:
+ * - pointer to the first of size() bytes; not terminated, and only valid until close()
+*/
+const char *MappedFile::data() const
+{
+    return mapping ? static_cast<const char*>(mapping) : buffer.data();
+}
+
+/* UTILITY METHOD: size - gets how many bytes the file has
+*/
+uint64_t MappedFile::size() const
+{
+    return length;
+}
+
+/* UTILITY METHOD: close - lets go of the file's bytes
+*/
+void MappedFile::close()
+{
+    if (mapping) munmap(mapping, length);
+    mapping = nullptr;
+    length = 0;
+    std::vector<char>().swap(buffer);
+}
+
+/* DECONSTRUCTOR - lets go of the file's bytes, if not already done
+*/
+MappedFile::~MappedFile()
+{
+    close();
+}
@@ -0,0 +1,136 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This file contains definitions for the methods declared in packed.h. Numbers are put together and taken |
+| apart one byte at a time, so the format comes out the same whatever the byte order of the machine.        |
+|===========================================================================================================|
+*/
+
+#include "packed.h"
+#include <string.h>
+
+// method forward declarations
+static void put_le(uint64_t value, uint8_t bytes, std::string *out);
+static uint64_t get_le(const char *data, uint8_t bytes);
+
+/* UTILITY METHOD: packed_width - gets how many bits a value of a factor takes in a packed row
+ *
+ * parameters:
+ * - level: the factor's level
+ *
+ * returns:
+ * - the fewest bits that can hold every value from 0 to level - 1; 0 when there is only the one value
+*/
+uint8_t packed_width(uint16_t level)
+{
+    uint8_t width = 0;
+    while (width < 16 && (static_cast<uint32_t>(1) << width) < level) width++;
+    return width;
+}
+
+/* UTILITY METHOD: packed_rows_offset - gets where the number of rows is in the header of a packed file
+ * - so that a writer can fill it in once it knows it
+ *
+ * parameters:
+ * - num_factors: how many factors the array has
+ *
+ * returns:
+ * - the offset in bytes from the start of the file
+*/
+uint64_t packed_rows_offset(uint16_t num_factors)
+{
+    return sizeof(PACKED_MAGIC) + 2 + 2*static_cast<uint64_t>(num_factors) + 3*2;
+}
+
+/* UTILITY METHOD: pack_header - appends the header of a packed file to some bytes
+ *
+ * parameters:
+ * - header: what the header should hold
+ * - bytes: pointer to the string to append to
+*/
+void pack_header(const PackedHeader &header, std::string *bytes)
+{
+    bytes->append(PACKED_MAGIC, sizeof(PACKED_MAGIC));
+    put_le(header.levels.size(), 2, bytes);
+    for (uint16_t level : header.levels) put_le(level, 2, bytes);
+    put_le(header.d, 2, bytes);
+    put_le(header.t, 2, bytes);
+    put_le(header.delta, 2, bytes);
+    put_le(header.rows, 8, bytes);
+    put_le(header.seed, 8, bytes);
+}
+
+/* UTILITY METHOD: is_packed - checks whether some bytes start like a packed file
+ *
+ * parameters:
+ * - data: pointer to the bytes
+ * - size: how many bytes there are
+ *
+ * returns:
+ * - true if they start with PACKED_MAGIC, false otherwise
+*/
+bool is_packed(const char *data, uint64_t size)
+{
+    return size >= sizeof(PACKED_MAGIC) && memcmp(data, PACKED_MAGIC, sizeof(PACKED_MAGIC)) == 0;
+}
+
+/* UTILITY METHOD: unpack_header - reads the header at the start of a packed file
+ *
+ * parameters:
+ * - data: pointer to the bytes of the file
+ * - size: how many bytes there are
+ * - header: pointer to where what the header holds should be stored
+ * - length: pointer to where the length of the header should be stored, which is where the rows start
+ *
+ * returns:
+ * - true if the bytes start with a whole header, false otherwise
+*/
+bool unpack_header(const char *data, uint64_t size, PackedHeader *header, uint64_t *length)
+{
+    if (!is_packed(data, size) || size < sizeof(PACKED_MAGIC) + 2) return false;
+    uint16_t num_factors = static_cast<uint16_t>(get_le(data + sizeof(PACKED_MAGIC), 2));
+    *length = packed_rows_offset(num_factors) + 2*8;
+    if (size < *length) return false;
+    const char *next = data + sizeof(PACKED_MAGIC) + 2;
+    header->levels.resize(num_factors);
+    for (uint16_t col = 0; col < num_factors; col++, next += 2)
+        header->levels[col] = static_cast<uint16_t>(get_le(next, 2));
+    header->d = static_cast<uint16_t>(get_le(next, 2));
+    header->t = static_cast<uint16_t>(get_le(next + 2, 2));
+    header->delta = static_cast<uint16_t>(get_le(next + 4, 2));
+    header->rows = get_le(next + 6, 8);
+    header->seed = get_le(next + 14, 8);
+    return true;
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+/* HELPER METHOD: put_le - appends a number to some bytes, lowest byte first
+ *
+ * parameters:
+ * - value: the number
+ * - bytes: how many bytes it should take
+ * - out: pointer to the string to append to
+*/
+static void put_le(uint64_t value, uint8_t bytes, std::string *out)
+{
+    for (uint8_t b = 0; b < bytes; b++) out->push_back(static_cast<char>((value >> (8*b)) & 0xff));
+}
+
+/* HELPER METHOD: get_le - reads a number written by put_le()
+ *
+ * parameters:
+ * - data: pointer to the first of its bytes
+ * - bytes: how many bytes it takes
+ *
+ * returns:
+ * - the number
+*/
+static uint64_t get_le(const char *data, uint8_t bytes)
+{
+    uint64_t value = 0;
+    for (uint8_t b = 0; b < bytes; b++)
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data[b])) << (8*b);
+    return value;
+}
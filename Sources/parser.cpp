@@ -1,5 +1,5 @@
 /* Array-Generator by Isaac Jung
-Last updated 12/22/2022
+Last updated 10/17/2026
 
 |===========================================================================================================|
 |   This file contains definitions for methods used to process input via an Parser class. Should the input  |
@@ -8,11 +8,15 @@ Last updated 12/22/2022
 */
 
 #include "parser.h"
+#include "mapped.h"
+#include "packed.h"
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <cstring>
 
 // method forward declarations
+bool read_value(const char **next, const char *end, int64_t *value);
 bool bad_t(uint16_t t, uint16_t num_cols);
 bool bad_d(uint16_t d, uint16_t t, std::vector<uint16_t> *levels, prop_mode p);
 bool bad_delta(uint16_t d, uint16_t t, uint16_t delta, std::vector<uint16_t> *levels);
@@ -34,20 +38,51 @@ Parser::Parser(int32_t argc, char *argv[]) : Parser()
 {
     int32_t itr = 1, num_params = 0;
     p = c_only;
-    bool multichar = false;
+    std::string multichar = "";    // multichar option waiting on the argument after it
     while (itr < argc) {
         std::string arg(argv[itr]);    // cast to std::string
-        if (multichar) {
+        if (multichar.compare("--partial") == 0) {
             if (partial_filename.empty()) partial_filename = arg;
             else printf("NOTE: --partial specified more than once, ignoring <%s>\n", arg.c_str());
-            multichar = false;
+            multichar = "";
             itr++;
             continue;
         }
-        if (arg.compare("--partial") == 0) {
-            multichar = true;
+        if (multichar.compare("--checkpoint") == 0 || multichar.compare("--resume") == 0) {
+            std::string *filename = multichar.compare("--checkpoint") == 0 ? &checkpoint_filename :
+                &resume_filename;
+            if (filename->empty()) *filename = arg;
+            else printf("NOTE: %s specified more than once, ignoring <%s>\n", multichar.c_str(), arg.c_str());
+            multichar = "";
             itr++;
-            continue;   // partial is the only multichar option here
+            continue;
+        }
+        if (multichar.compare("--score-cache") == 0 || multichar.compare("--memory-budget") == 0 ||
+            multichar.compare("--flush-every") == 0 || multichar.compare("--checkpoint-every") == 0 ||
+            multichar.compare("--seed") == 0) {
+            if (multichar.compare("--score-cache") == 0) read_number(multichar, arg, &score_cache_mib);
+            else if (multichar.compare("--memory-budget") == 0) read_number(multichar, arg, &memory_budget_mib);
+            else if (multichar.compare("--flush-every") == 0) read_number(multichar, arg, &flush_seconds);
+            else if (multichar.compare("--seed") == 0) {
+                if (read_number(multichar, arg, &seed)) has_seed = true;
+            }
+            else read_number(multichar, arg, &checkpoint_every);
+            multichar = "";
+            itr++;
+            continue;
+        }
+        if (arg.compare("--binary") == 0) {
+            binary = true;
+            itr++;
+            continue;
+        }
+        if (arg.compare("--partial") == 0 || arg.compare("--score-cache") == 0 ||
+            arg.compare("--memory-budget") == 0 || arg.compare("--flush-every") == 0 ||
+            arg.compare("--checkpoint") == 0 || arg.compare("--checkpoint-every") == 0 ||
+            arg.compare("--resume") == 0 || arg.compare("--seed") == 0) {
+            multichar = arg;
+            itr++;
+            continue;
         }
         if (arg.at(0) == '-') { // flags
             for (char c : arg.substr(1, arg.length() - 1)) {
@@ -160,58 +195,109 @@ int32_t Parser::process_input()
     if (p == all && bad_delta(d, t, delta, &levels)) return -1;
     if (partial_filename.empty()) return 0;
 
-    // partial array
-    try {
-        partial.open(partial_filename.c_str(), std::ifstream::in);
-        if (!partial.is_open()) throw 0;
-    } catch ( ... ) {
+    // partial array, read straight out of the mapped file into one row matrix
+    MappedFile partial;
+    if (!partial.open(partial_filename)) {
         printf("\t-- ERROR --\n\tUnable to open file with path name <%s>.\n", partial_filename.c_str());
         printf("\tFor usage details, rerun with --help or consult the README.\n");
         printf("\n");
         return -1;
     }
-    uint16_t *row;
+    if (is_packed(partial.data(), partial.size())) return read_packed(partial.data(), partial.size());
+    const char *next = partial.data(), *end = next + partial.size();
+    array.reserve((static_cast<uint64_t>(std::count(next, end, '\n')) + 1)*num_cols);  // a row per line at most
     uint64_t i = 0;
-    while (std::getline(partial, cur_line)) {
+    while (next < end) {
+        const char *line = next;
+        const char *line_end = static_cast<const char*>(memchr(line, '\n', static_cast<size_t>(end - line)));
+        if (!line_end) line_end = end;
         i++;
-        try {
-            std::istringstream iss(cur_line);
-            for (uint16_t j = 0; j < num_cols; j++) {
-                int32_t next_val;
-                if (!(iss >> next_val)) throw 0;
-                if (next_val < 0) {
-                    partial.close();
-                    semantic_error(i, i, j+1, levels.at(j), 0, next_val, false);
-                    return -1;
-                }
+        // every value must be a number, and not negative, before any is checked against its level
+        uint16_t bad_col = 0;   // first column whose value is out of range, if any
+        int64_t bad_value = 0;
+        for (uint16_t j = 0; j < num_cols; j++) {
+            int64_t value;
+            if (!read_value(&next, line_end, &value)) {
+                other_error(i, std::string(line, line_end));
+                return -1;
             }
-        } catch (...) {
-            partial.close();
-            other_error(i, cur_line);
-            return -1;
-        }
-        try {
-            row = new uint16_t[num_cols];
-            std::istringstream iss(cur_line);
-            for (uint16_t j = 0; j < num_cols; j++) {
-                if (!(iss >> row[j])) throw 0;
-                if (row[j] >= levels.at(j)) {   // error when array value out of range
-                    partial.close();
-                    semantic_error(i, i, j+1, levels.at(j), row[j], 0, false);
-                    delete[] row;
-                    return -1;
-                }
+            if (value < 0) {
+                semantic_error(i, i, j+1, levels.at(j), 0, static_cast<int32_t>(value), false);
+                return -1;
+            }
+            if (bad_col == 0 && value >= levels.at(j)) {
+                bad_col = j + 1;
+                bad_value = value;
             }
-        } catch (...) {
-            partial.close();
-            other_error(i, cur_line);
-            delete[] row;
+            array.push_back(static_cast<uint16_t>(value));
+        }
+        if (bad_col != 0) {
+            if (bad_value > UINT16_MAX) other_error(i, std::string(line, line_end));   // not even a level
+            else semantic_error(i, i, bad_col, levels.at(bad_col - 1), static_cast<uint16_t>(bad_value), 0,
+                false);
             return -1;
         }
-        array.push_back(row);
         num_rows++;
+        next = line_end + 1;    // anything after the last column is ignored
     }
-    partial.close();
+    return 0;
+}
+
+/* HELPER METHOD: read_packed - reads a partial array written in the packed binary format (see packed.h)
+ * - the factors in its header must be those of the input file; the d, t, δ, and seed it was generated with
+ *   do not matter here
+ * 
+ * parameters:
+ * - data: pointer to the bytes of the partial array file
+ * - size: how many bytes there are
+ * 
+ * returns:
+ * - code representing success/failure, as for process_input()
+*/
+int32_t Parser::read_packed(const char *data, uint64_t size)
+{
+    PackedHeader header;
+    uint64_t offset;
+    if (!unpack_header(data, size, &header, &offset)) {
+        packed_error("its header is cut short");
+        return -1;
+    }
+    if (header.levels != levels) {
+        packed_error("its factors are not the ones given in " + in_filename);
+        return -1;
+    }
+    std::vector<uint8_t> widths(num_cols);
+    uint64_t row_bits = 0;
+    for (uint16_t j = 0; j < num_cols; j++) row_bits += widths[j] = packed_width(levels[j]);
+    uint64_t available = size - offset;
+    uint64_t count = header.rows;
+    if (count == PACKED_UNKNOWN_ROWS) count = row_bits == 0 ? 0 : available*8/row_bits;   // never finished
+    else if (row_bits == 0 ? count > array.max_size()/num_cols : count > available*8/row_bits) {
+        packed_error("it says it has " + std::to_string(count) + " rows, but is cut short");
+        return -1;
+    }
+
+    // values are read lowest bit first, out of a word of bits topped up a byte at a time
+    array.resize(count*num_cols);
+    const uint8_t *next = reinterpret_cast<const uint8_t*>(data + offset);
+    uint64_t bits = 0;
+    uint8_t num_bits = 0;
+    for (uint64_t i = 0; i < count; i++)
+        for (uint16_t j = 0; j < num_cols; j++) {
+            for (; num_bits < widths[j]; num_bits = static_cast<uint8_t>(num_bits + 8))
+                bits |= static_cast<uint64_t>(*next++) << num_bits;
+            uint16_t value = static_cast<uint16_t>(bits & ((static_cast<uint64_t>(1) << widths[j]) - 1));
+            bits >>= widths[j];
+            num_bits = static_cast<uint8_t>(num_bits - widths[j]);
+            if (value >= levels[j]) {
+                packed_error("row " + std::to_string(i + 1) + ", column " + std::to_string(j + 1) +
+                    " has value " + std::to_string(value) + ", but the level for that factor was given as " +
+                    std::to_string(levels[j]), false);
+                return -1;
+            }
+            array[i*num_cols + j] = value;
+        }
+    num_rows = count;
     return 0;
 }
 
@@ -237,6 +323,31 @@ void Parser::trim(std::string &s) {
 }
 // ======================================================================================================= //
 
+/* HELPER METHOD: read_number - reads the number given after a multichar option that takes one, such as a
+ * size in MiB or a number of seconds
+ * 
+ * parameters:
+ * - option: the option the number was given for, for the message when it is bad
+ * - arg: the argument following the option
+ * - number: pointer to where the number should be stored; left alone if the number is bad
+ * 
+ * returns:
+ * - true if *number now holds the number, false if a note was printed instead
+*/
+bool Parser::read_number(const std::string &option, const std::string &arg, uint64_t *number)
+{
+    if (arg.empty() || arg.find_first_not_of("0123456789") != std::string::npos) {
+        printf("NOTE: bad value <%s> for %s; ignored\n", arg.c_str(), option.c_str());
+        return false;
+    }
+    try {
+        *number = std::stoull(arg);
+    } catch ( ... ) {   // too big to even count, so effectively no limit
+        *number = UINT64_MAX;
+    }
+    return true;
+}
+
 /* HELPER METHOD: syntax_error - prints an error message regarding input format
  * 
  * parameters:
@@ -284,6 +395,22 @@ void Parser::semantic_error(uint64_t lineno, uint64_t row, uint16_t col, uint16_
     printf("\n");
 }
 
+/* HELPER METHOD: packed_error - prints an error message regarding a partial array in the packed format
+ *
+ * parameters:
+ * - problem: what is wrong with it
+ * - verbose: whether to print extra error output (true by default)
+ * 
+ * returns:
+ * - void (caller should decide whether to quit or continue)
+*/
+void Parser::packed_error(std::string problem, bool verbose)
+{
+    printf("\t-- ERROR --\n\tCould not read packed array %s: %s.\n", partial_filename.c_str(), problem.c_str());
+    if (verbose) printf("\tFor formatting details, please check the README.\n");
+    printf("\n");
+}
+
 /* HELPER METHOD: other_error - prints a general error message
  *
  * parameters:
@@ -302,15 +429,36 @@ void Parser::other_error(uint64_t lineno, std::string line, bool verbose)
     printf("\n");
 }
 
-/* DECONSTRUCTOR - frees memory
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+/* HELPER METHOD: read_value - reads the next integer on a line, the same way std::istream would read an int
+ * - leading whitespace is skipped, a sign is allowed, and reading stops at the first character that is not a
+ *   digit, which is left for the next call
+ * 
+ * parameters:
+ * - next: pointer to where reading starts; moved past what was read
+ * - end: end of the line, which reading never goes past
+ * - value: pointer to where the integer should be stored
+ * 
+ * returns:
+ * - true if an integer was read, false if there was none or it does not fit in an int
 */
-Parser::~Parser()
+bool read_value(const char **next, const char *end, int64_t *value)
 {
-    for (uint16_t *row : array) delete[] row;
+    const char *c = *next;
+    while (c < end && isspace(static_cast<unsigned char>(*c))) c++;
+    bool negative = c < end && *c == '-';
+    if (c < end && (*c == '-' || *c == '+')) c++;
+    const char *digits = c;
+    int64_t magnitude = 0;
+    for (; c < end && *c >= '0' && *c <= '9'; c++)
+        if (magnitude <= INT32_MAX) magnitude = magnitude*10 + (*c - '0'); // past the limit is too big anyway
+    *next = c;
+    if (c == digits || magnitude > static_cast<int64_t>(INT32_MAX) + negative) return false;
+    *value = negative ? -magnitude : magnitude;
+    return true;
 }
 
-// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
-
 bool bad_t(uint16_t t, uint16_t num_cols)
 {
     if (t > num_cols) {
@@ -357,6 +505,10 @@ bool bad_delta(uint16_t d, uint16_t t, uint16_t delta, std::vector<uint16_t> *le
         printf("\t-- ERROR --\n\tδ cannot be 0.\n\n");
         return true;
     }
+    if (delta > UINT8_MAX) {   // separations are tracked in 8 bits each
+        printf("\t-- ERROR --\n\tδ cannot be greater than %d.\n\n", UINT8_MAX);
+        return true;
+    }
     for (uint16_t level : *levels) {
         if (level <= d) {
             printf("\t-- ERROR --\n");
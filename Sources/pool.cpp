@@ -0,0 +1,152 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the ThreadPool class declared in pool.h. The    |
+| state mutex is only ever held for bookkeeping; the per-worker queue mutexes are only ever held to push or |
+| pop a single task, and neither is held while a task is running.                                           |
+|===========================================================================================================|
+*/
+
+#include "pool.h"
+
+/* CONSTRUCTOR - initializes the object
+ * - starts the workers right away; they sleep until there is work to do
+ *
+ * parameters:
+ * - num_workers: number of worker threads to start; 0 is treated as 1
+ * - max_queued_o: number of tasks allowed to wait in the queues before submit() blocks; 0 is treated as 1
+*/
+ThreadPool::ThreadPool(uint32_t num_workers, uint64_t max_queued_o) :
+    max_queued(max_queued_o == 0 ? 1 : max_queued_o)
+{
+    if (num_workers == 0) num_workers = 1;
+    for (uint32_t id = 0; id < num_workers; id++) queues.push_back(new WorkQueue());
+    try {
+        for (uint32_t id = 0; id < num_workers; id++)
+            workers.push_back(std::thread(&ThreadPool::work, this, id));
+    } catch (...) { // could not start them all, so stop the ones that did start before giving up
+        state_mutex.lock();
+        stopping = true;
+        state_mutex.unlock();
+        work_ready.notify_all();
+        for (std::thread &worker : workers) worker.join();
+        for (WorkQueue *queue : queues) delete queue;
+        throw;
+    }
+}
+
+/* UTILITY METHOD: submit - hands a task to the workers
+ * - tasks go to the workers' queues in turn; if max_queued tasks are already waiting, this blocks until
+ *   one of them is taken
+ *
+ * parameters:
+ * - task: the work to run; it must not throw, and it must not call submit() or wait() on this pool
+ *
+ * returns:
+ * - void, but after the method finishes, the task will be queued (it may even be finished already)
+*/
+void ThreadPool::submit(std::function<void()> task)
+{
+    std::unique_lock<std::mutex> state(state_mutex);
+    space_ready.wait(state, [this] { return queued < max_queued; });
+    WorkQueue *queue = queues[next_queue];
+    next_queue = (next_queue + 1) % queues.size();
+    queue->lock.lock();
+    queue->tasks.push_back(std::move(task));
+    queue->lock.unlock();
+    queued++;
+    unfinished++;
+    state.unlock();
+    work_ready.notify_one();
+}
+
+/* UTILITY METHOD: wait - blocks until every task submitted so far has finished running
+*/
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> state(state_mutex);
+    all_done.wait(state, [this] { return unfinished == 0; });
+}
+
+/* UTILITY METHOD: size - gets the number of worker threads
+*/
+uint32_t ThreadPool::size() const
+{
+    return static_cast<uint32_t>(workers.size());
+}
+
+/* HELPER METHOD: work - the loop run by each worker thread until the pool is destroyed
+ *
+ * parameters:
+ * - id: index of this worker, which is also the index of its own queue
+*/
+void ThreadPool::work(uint32_t id)
+{
+    std::function<void()> task;
+    while (true) {
+        if (take(id, &task)) {
+            state_mutex.lock();
+            queued--;
+            state_mutex.unlock();
+            space_ready.notify_one();
+            task();
+            task = nullptr; // release anything the task captured before reporting it finished
+            state_mutex.lock();
+            bool last = --unfinished == 0;
+            state_mutex.unlock();
+            if (last) all_done.notify_all();
+            continue;
+        }
+        std::unique_lock<std::mutex> state(state_mutex);
+        if (stopping) return;
+        if (queued > 0) {   // another worker has taken it but not yet said so; let that worker catch up
+            state.unlock();
+            std::this_thread::yield();
+            continue;
+        }
+        work_ready.wait(state, [this] { return stopping || queued > 0; });
+    }
+}
+
+/* HELPER METHOD: take - gets the next task for a worker
+ * - the worker's own queue is tried first, from the front; then the other queues are tried in turn, from
+ *   the back, which is where a busy worker's least urgent task is
+ *
+ * parameters:
+ * - id: index of the worker asking for a task
+ * - task: pointer to where the task taken should be stored
+ *
+ * returns:
+ * - true if a task was taken, false if every queue was empty
+*/
+bool ThreadPool::take(uint32_t id, std::function<void()> *task)
+{
+    for (uint64_t offset = 0; offset < queues.size(); offset++) {
+        WorkQueue *queue = queues[(id + offset) % queues.size()];
+        std::lock_guard<std::mutex> guard(queue->lock);
+        if (queue->tasks.empty()) continue;
+        if (offset == 0) {
+            *task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+        } else {
+            *task = std::move(queue->tasks.back());
+            queue->tasks.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+/* DECONSTRUCTOR - frees memory
+ * - tasks still waiting in the queues are run before the workers return; call wait() first to be sure of it
+*/
+ThreadPool::~ThreadPool()
+{
+    state_mutex.lock();
+    stopping = true;
+    state_mutex.unlock();
+    work_ready.notify_all();
+    for (std::thread &worker : workers) worker.join();
+    for (WorkQueue *queue : queues) delete queue;
+}
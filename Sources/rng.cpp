@@ -0,0 +1,92 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the Rng class declared in rng.h.                |
+|===========================================================================================================|
+*/
+
+#include "rng.h"
+
+// method forward declarations
+static uint64_t rotate_left(uint64_t x, uint8_t k);
+
+/* CONSTRUCTOR - initializes the object
+ *
+ * parameters:
+ * - seed_o: see seed()
+*/
+Rng::Rng(uint64_t seed_o)
+{
+    seed(seed_o);
+}
+
+/* UTILITY METHOD: seed - sets the state of the generator from a single number
+ * - the number is spread over the whole state with splitmix64, as the authors of xoshiro suggest, so that
+ *   even seeds that differ by a single bit start far apart, and the state is never all zeros
+ *
+ * parameters:
+ * - seed_o: any number; the same one always leads to the same numbers being drawn
+*/
+void Rng::seed(uint64_t seed_o)
+{
+    for (uint64_t &word : state) {
+        seed_o += 0x9e3779b97f4a7c15ULL;
+        uint64_t z = seed_o;
+        z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27))*0x94d049bb133111ebULL;
+        word = z ^ (z >> 31);
+    }
+}
+
+/* UTILITY METHOD: next - draws a random number
+ *
+ * returns:
+ * - a number anywhere in the 64-bit range
+*/
+uint64_t Rng::next()
+{
+    uint64_t result = rotate_left(state[1]*5, 7)*9;
+    uint64_t t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = rotate_left(state[3], 45);
+    return result;
+}
+
+/* UTILITY METHOD: below - draws a random number less than a bound
+ * - numbers from the top of the range that would make the lower results more likely than the rest are
+ *   thrown back, which is rarely more than one draw
+ *
+ * parameters:
+ * - bound: one past the largest number wanted; must not be 0
+ *
+ * returns:
+ * - a number from 0 to bound - 1, all equally likely
+*/
+uint64_t Rng::below(uint64_t bound)
+{
+    uint64_t threshold = (0 - bound) % bound;   // 2^64 % bound
+    uint64_t r;
+    do r = next(); while (r < threshold);
+    return r % bound;
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+/* HELPER METHOD: rotate_left - rotates the bits of a number
+ *
+ * parameters:
+ * - x: the number
+ * - k: how many places to rotate by, from 1 to 63
+ *
+ * returns:
+ * - x with its bits rotated k places towards the top, the top k coming around to the bottom
+*/
+static uint64_t rotate_left(uint64_t x, uint8_t k)
+{
+    return (x << k) | (x >> (64 - k));
+}
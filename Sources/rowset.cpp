@@ -0,0 +1,114 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the RowSet class declared in rowset.h. Unions   |
+| are done one 64-bit word at a time, using the compiler's popcount builtin to recount the size afterwards. |
+|===========================================================================================================|
+*/
+
+#include "rowset.h"
+
+/* UTILITY METHOD: insert - adds a row to the set, growing the underlying words as needed
+ *
+ * parameters:
+ * - row: the row number to add
+ *
+ * returns:
+ * - void, but after the method finishes, the row will be in the set
+*/
+void RowSet::insert(uint64_t row)
+{
+    uint64_t idx = row >> 6;
+    if (idx >= words.size()) words.resize(idx + 1, 0);
+    uint64_t bit = static_cast<uint64_t>(1) << (row & 63);
+    if (!(words[idx] & bit)) {
+        words[idx] |= bit;
+        count++;
+    }
+}
+
+/* UTILITY METHOD: size - gets the number of rows in the set
+ *
+ * returns:
+ * - the number of rows in the set (memoized, so this is constant time)
+*/
+uint64_t RowSet::size() const
+{
+    return count;
+}
+
+/* UTILITY METHOD: empty - checks whether the set has no rows
+ *
+ * returns:
+ * - true if there are no rows in the set
+*/
+bool RowSet::empty() const
+{
+    return count == 0;
+}
+
+/* UTILITY METHOD: unite - turns this set into its union with another
+ *
+ * parameters:
+ * - other: the set whose rows should be added to this one
+ *
+ * returns:
+ * - void, but after the method finishes, this set will contain every row of other as well
+*/
+void RowSet::unite(const RowSet &other)
+{
+    if (other.words.size() > words.size()) words.resize(other.words.size(), 0);
+    for (uint64_t i = 0; i < other.words.size(); i++) words[i] |= other.words[i];
+    recount();
+}
+
+RowSet::const_iterator RowSet::begin() const
+{
+    return const_iterator(&words, 0, words.empty() ? 0 : words[0]);
+}
+
+RowSet::const_iterator RowSet::end() const
+{
+    return const_iterator(&words, words.size(), 0);
+}
+
+/* HELPER METHOD: recount - recomputes the memoized size after a word-parallel mutation
+*/
+void RowSet::recount()
+{
+    count = 0;
+    for (uint64_t word : words) count += static_cast<uint64_t>(__builtin_popcountll(word));
+}
+
+/* CONSTRUCTOR - initializes the object
+ * - skips ahead to the first set bit at or after the given position, so begin() lands on the first row
+*/
+RowSet::const_iterator::const_iterator(const std::vector<uint64_t> *w, uint64_t idx, uint64_t cur) :
+    words(w), word_idx(idx), bits(cur)
+{
+    while (bits == 0 && word_idx < words->size()) {
+        word_idx++;
+        if (word_idx < words->size()) bits = (*words)[word_idx];
+    }
+}
+
+uint64_t RowSet::const_iterator::operator*() const
+{
+    return (word_idx << 6) + static_cast<uint64_t>(__builtin_ctzll(bits));
+}
+
+RowSet::const_iterator &RowSet::const_iterator::operator++()
+{
+    bits &= bits - 1;   // clear the lowest set bit, which is the row that was just visited
+    while (bits == 0 && word_idx < words->size()) {
+        word_idx++;
+        if (word_idx < words->size()) bits = (*words)[word_idx];
+    }
+    return *this;
+}
+
+bool RowSet::const_iterator::operator!=(const const_iterator &other) const
+{
+    return word_idx != other.word_idx || bits != other.bits;
+}
@@ -0,0 +1,204 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the RowSink class declared in sink.h. The file  |
+| is written through the C standard library, but with its own buffering turned off, since the sink already  |
+| decides when text is handed over; each flush is then a single write straight to the file.                 |
+|===========================================================================================================|
+*/
+
+#include "sink.h"
+
+const uint64_t RowSink::BUFFER_BYTES;
+
+/* CONSTRUCTOR - initializes the object
+ *
+ * parameters:
+ * - flush_seconds_o: longest time a written row may wait in the buffer, checked as each row is written; 0
+ *   means every row is flushed as soon as it is written
+*/
+RowSink::RowSink(uint64_t flush_seconds_o) : flush_seconds(flush_seconds_o),
+    last_flush(std::chrono::steady_clock::now())
+{
+    buffer.reserve(BUFFER_BYTES);
+}
+
+/* UTILITY METHOD: open - starts writing into a file
+ * - overloaded: this version opens the file by name, truncating it, and closes it again in close()
+ *
+ * parameters:
+ * - filename: path of the file to write
+ *
+ * returns:
+ * - true if the file could be opened, false otherwise (in which case the sink stays closed)
+*/
+bool RowSink::open(const std::string &filename)
+{
+    close();
+    file = std::fopen(filename.c_str(), "w");
+    if (!file) return false;
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    owned = true;
+    failed = false;
+    last_flush = std::chrono::steady_clock::now();
+    return true;
+}
+
+/* UTILITY METHOD: open_packed - starts writing packed rows into a file
+ * - the header goes out first, saying the number of rows is unknown; close() fills it in, if the file can be
+ *   written at more than one place (a pipe cannot, and is left saying unknown)
+ *
+ * parameters:
+ * - filename: path of the file to write
+ * - header: what the header should hold, other than the number of rows
+ *
+ * returns:
+ * - true if the file could be opened, false otherwise (in which case the sink stays closed)
+*/
+bool RowSink::open_packed(const std::string &filename, const PackedHeader &header)
+{
+    if (!open(filename)) return false;
+    widths.clear();
+    for (uint16_t level : header.levels) widths.push_back(packed_width(level));
+    pending = 0;
+    pending_bits = 0;
+    rows_written = 0;
+    rows_offset = packed_rows_offset(static_cast<uint16_t>(header.levels.size()));
+    PackedHeader unfinished = header;
+    unfinished.rows = PACKED_UNKNOWN_ROWS;
+    pack_header(unfinished, &buffer);
+    flush();
+    return true;
+}
+
+/* UTILITY METHOD: open - starts writing into a stream
+ * - overloaded: this version takes a stream that is already open, such as stdout, and leaves it open
+ *
+ * parameters:
+ * - stream: the stream to write
+*/
+void RowSink::open(std::FILE *stream)
+{
+    close();
+    file = stream;
+    owned = false;
+    failed = false;
+    last_flush = std::chrono::steady_clock::now();
+}
+
+/* UTILITY METHOD: is_open - checks whether the sink has somewhere to write to
+*/
+bool RowSink::is_open() const
+{
+    return file != nullptr;
+}
+
+/* UTILITY METHOD: write - appends a row to the sink
+ * - the row is buffered, and the buffer is flushed if it is full or the flush interval has gone by
+ *
+ * parameters:
+ * - row: the values of the row
+ * - num_factors: how many values the row has
+ *
+ * returns:
+ * - void, but after the method finishes, the row will be in the buffer or in the file; nothing happens if
+ *   the sink is not open
+*/
+void RowSink::write(const uint16_t *row, uint16_t num_factors)
+{
+    if (!file) return;
+    if (widths.empty()) format(row, num_factors, &buffer);
+    else pack(row, num_factors);
+    if (buffer.size() >= BUFFER_BYTES || std::chrono::steady_clock::now() - last_flush >=
+        std::chrono::seconds(flush_seconds)) flush();
+}
+
+/* UTILITY METHOD: flush - hands everything buffered over to the file
+ *
+ * returns:
+ * - false if any write to the file has failed so far, true otherwise
+*/
+bool RowSink::flush()
+{
+    if (!file) return !failed;
+    if (!buffer.empty() && std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size()) failed = true;
+    if (std::fflush(file) != 0) failed = true;
+    buffer.clear();
+    last_flush = std::chrono::steady_clock::now();
+    return !failed;
+}
+
+/* UTILITY METHOD: close - flushes the sink and stops writing
+ * - the file is only closed if the sink was the one to open it
+ *
+ * returns:
+ * - false if any write to the file has failed, true otherwise
+*/
+bool RowSink::close()
+{
+    if (!file) return !failed;
+    if (!widths.empty()) {
+        if (pending_bits > 0) buffer.push_back(static_cast<char>(pending));   // pads the last byte with zeros
+        flush();
+        std::string count;  // the header is little-endian, just like pack_header() makes it
+        for (uint8_t b = 0; b < 8; b++) count.push_back(static_cast<char>((rows_written >> (8*b)) & 0xff));
+        if (std::fseek(file, static_cast<long>(rows_offset), SEEK_SET) == 0 &&
+            std::fwrite(count.data(), 1, count.size(), file) != count.size()) failed = true;
+        widths.clear();
+    }
+    flush();
+    if (owned && std::fclose(file) != 0) failed = true;
+    file = nullptr;
+    owned = false;
+    return !failed;
+}
+
+/* UTILITY METHOD: format - appends the text of a row to a string
+ * - each value is followed by a tab, and the row ends with a newline
+ *
+ * parameters:
+ * - row: the values of the row
+ * - num_factors: how many values the row has
+ * - text: pointer to the string to append to
+*/
+void RowSink::format(const uint16_t *row, uint16_t num_factors, std::string *text)
+{
+    char digits[6];     // enough for any uint16_t
+    for (uint16_t i = 0; i < num_factors; i++) {
+        uint16_t value = row[i];
+        uint8_t len = 0;
+        do {
+            digits[len++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value > 0);
+        while (len > 0) text->push_back(digits[--len]);
+        text->push_back('\t');
+    }
+    text->push_back('\n');
+}
+
+/* HELPER METHOD: pack - appends a row to the buffer in the packed format
+ * - whole bytes go into the buffer, and whatever bits are left over wait in pending for the next row
+ *
+ * parameters:
+ * - row: the values of the row
+ * - num_factors: how many values the row has
+*/
+void RowSink::pack(const uint16_t *row, uint16_t num_factors)
+{
+    for (uint16_t i = 0; i < num_factors; i++) {
+        pending |= static_cast<uint64_t>(row[i]) << pending_bits;
+        pending_bits = static_cast<uint8_t>(pending_bits + widths[i]);
+        for (; pending_bits >= 8; pending_bits = static_cast<uint8_t>(pending_bits - 8), pending >>= 8)
+            buffer.push_back(static_cast<char>(pending & 0xff));
+    }
+    rows_written++;
+}
+
+/* DECONSTRUCTOR - flushes and closes the file, if still open
+*/
+RowSink::~RowSink()
+{
+    close();
+}
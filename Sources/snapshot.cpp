@@ -0,0 +1,270 @@
+/* Array-Generator by Isaac Jung
+Last updated 10/17/2026
+
+|===========================================================================================================|
+|   This file contains definitions for methods belonging to the SnapshotWriter and SnapshotReader classes   |
+| declared in snapshot.h. Failures are remembered rather than reported one by one, so the caller can write  |
+| or read everything in a row and check only once at the end.                                               |
+|===========================================================================================================|
+*/
+
+#include "snapshot.h"
+#include <unistd.h>
+#include <string.h>
+
+// method forward declarations
+static uint64_t snapshot_checksum(uint64_t checksum, const void *data, uint64_t bytes);
+
+/* UTILITY METHOD: open - starts writing a snapshot
+ * - nothing is written to filename itself until commit()
+ *
+ * parameters:
+ * - filename: path of the file the snapshot should end up in
+ *
+ * returns:
+ * - true if the temporary file could be opened, false otherwise
+*/
+bool SnapshotWriter::open(const std::string &filename)
+{
+    path = filename;
+    temp_path = filename + ".tmp";
+    file = std::fopen(temp_path.c_str(), "wb");
+    failed = !file;
+    return file != nullptr;
+}
+
+/* UTILITY METHOD: put - writes raw bytes
+ *
+ * parameters:
+ * - data: pointer to the bytes
+ * - bytes: how many bytes to write
+*/
+void SnapshotWriter::put(const void *data, uint64_t bytes)
+{
+    if (failed || bytes == 0) return;
+    if (std::fwrite(data, 1, bytes, file) != bytes) failed = true;
+    checksum = snapshot_checksum(checksum, data, bytes);
+}
+
+/* UTILITY METHOD: put_u64 - writes one number
+*/
+void SnapshotWriter::put_u64(uint64_t value)
+{
+    put(&value, sizeof(value));
+}
+
+/* UTILITY METHOD: put_u8s - writes a vector of bytes, preceded by its length
+*/
+void SnapshotWriter::put_u8s(const std::vector<uint8_t> &values)
+{
+    put_u64(values.size());
+    put(values.data(), values.size()*sizeof(uint8_t));
+}
+
+/* UTILITY METHOD: put_u16s - writes a vector of 16-bit numbers, preceded by its length
+*/
+void SnapshotWriter::put_u16s(const std::vector<uint16_t> &values)
+{
+    put_u64(values.size());
+    put(values.data(), values.size()*sizeof(uint16_t));
+}
+
+/* UTILITY METHOD: put_u64s - writes a vector of 64-bit numbers, preceded by its length
+*/
+void SnapshotWriter::put_u64s(const std::vector<uint64_t> &values)
+{
+    put_u64(values.size());
+    put(values.data(), values.size()*sizeof(uint64_t));
+}
+
+/* UTILITY METHOD: commit - finishes the snapshot and puts it in place of whatever filename had
+ * - the checksum goes last; the temporary file is flushed all the way to disk before the rename, so that
+ *   the rename never leaves filename pointing at a file that is only partly written
+ *
+ * returns:
+ * - true if the whole snapshot is now in filename, false otherwise (in which case filename is untouched)
+*/
+bool SnapshotWriter::commit()
+{
+    if (!file) return false;
+    put_u64(checksum);
+    if (std::fflush(file) != 0 || fsync(fileno(file)) != 0) failed = true;
+    if (std::fclose(file) != 0) failed = true;
+    file = nullptr;
+    if (!failed && std::rename(temp_path.c_str(), path.c_str()) != 0) failed = true;
+    if (failed) std::remove(temp_path.c_str());
+    return !failed;
+}
+
+/* DECONSTRUCTOR - throws away the temporary file, if it was never committed
+*/
+SnapshotWriter::~SnapshotWriter()
+{
+    if (!file) return;
+    std::fclose(file);
+    std::remove(temp_path.c_str());
+}
+
+/* UTILITY METHOD: open - starts reading a snapshot
+ *
+ * parameters:
+ * - filename: path of the snapshot
+ *
+ * returns:
+ * - true if the file could be opened, false otherwise
+*/
+bool SnapshotReader::open(const std::string &filename)
+{
+    file = std::fopen(filename.c_str(), "rb");
+    if (!file || std::fseek(file, 0, SEEK_END) != 0) {
+        failed = true;
+        return false;
+    }
+    long size = std::ftell(file);
+    if (size < 0 || std::fseek(file, 0, SEEK_SET) != 0) {
+        failed = true;
+        return false;
+    }
+    remaining = static_cast<uint64_t>(size);
+    return true;
+}
+
+/* UTILITY METHOD: get - reads raw bytes
+ *
+ * parameters:
+ * - data: pointer to where the bytes should be stored
+ * - bytes: how many bytes to read
+ *
+ * returns:
+ * - true if all of them were read, false otherwise (and from then on)
+*/
+bool SnapshotReader::get(void *data, uint64_t bytes)
+{
+    if (failed) return false;
+    if (bytes > remaining || std::fread(data, 1, bytes, file) != bytes) {
+        failed = true;
+        return false;
+    }
+    remaining -= bytes;
+    checksum = snapshot_checksum(checksum, data, bytes);
+    return true;
+}
+
+/* UTILITY METHOD: get_u64 - reads one number
+ *
+ * returns:
+ * - the number, or 0 if it could not be read
+*/
+uint64_t SnapshotReader::get_u64()
+{
+    uint64_t value = 0;
+    if (!get(&value, sizeof(value))) return 0;
+    return value;
+}
+
+/* UTILITY METHOD: get_u8s - reads a vector of bytes written by SnapshotWriter::put_u8s()
+ *
+ * parameters:
+ * - values: pointer to the vector to fill in
+ * - resize: whether the vector should take whatever length was written, rather than having to match it
+ *
+ * returns:
+ * - true if the vector was read, false otherwise
+*/
+bool SnapshotReader::get_u8s(std::vector<uint8_t> *values, bool resize)
+{
+    uint64_t length;
+    if (!get_length(values->size(), sizeof(uint8_t), resize, &length)) return false;
+    values->resize(length);
+    return get(values->data(), length*sizeof(uint8_t));
+}
+
+/* UTILITY METHOD: get_u16s - reads a vector of 16-bit numbers written by SnapshotWriter::put_u16s()
+ * - see get_u8s() for the parameters
+*/
+bool SnapshotReader::get_u16s(std::vector<uint16_t> *values, bool resize)
+{
+    uint64_t length;
+    if (!get_length(values->size(), sizeof(uint16_t), resize, &length)) return false;
+    values->resize(length);
+    return get(values->data(), length*sizeof(uint16_t));
+}
+
+/* UTILITY METHOD: get_u64s - reads a vector of 64-bit numbers written by SnapshotWriter::put_u64s()
+ * - see get_u8s() for the parameters
+*/
+bool SnapshotReader::get_u64s(std::vector<uint64_t> *values, bool resize)
+{
+    uint64_t length;
+    if (!get_length(values->size(), sizeof(uint64_t), resize, &length)) return false;
+    values->resize(length);
+    return get(values->data(), length*sizeof(uint64_t));
+}
+
+/* UTILITY METHOD: at_end - checks that the whole snapshot was read without trouble
+ * - reads the checksum, so should be called once, after everything else has been read
+*/
+bool SnapshotReader::at_end()
+{
+    uint64_t expected = checksum;
+    return get_u64() == expected && !failed && remaining == 0;
+}
+
+/* UTILITY METHOD: ok - checks that nothing has gone wrong so far
+*/
+bool SnapshotReader::ok() const
+{
+    return !failed;
+}
+
+/* HELPER METHOD: get_length - reads the length in front of a vector, and checks it
+ *
+ * parameters:
+ * - size: the current size of the vector
+ * - width: bytes per element
+ * - resize: whether the length may differ from size
+ * - length: pointer to where the length should be stored
+ *
+ * returns:
+ * - true if the length is acceptable and the file has that many elements left, false otherwise
+*/
+bool SnapshotReader::get_length(uint64_t size, uint64_t width, bool resize, uint64_t *length)
+{
+    *length = get_u64();
+    if (failed || (!resize && *length != size) || *length > remaining/width) failed = true;
+    return !failed;
+}
+
+/* DECONSTRUCTOR - closes the file
+*/
+SnapshotReader::~SnapshotReader()
+{
+    if (file) std::fclose(file);
+}
+
+// ==============================   LOCAL HELPER METHODS BELOW THIS POINT   ============================== //
+
+/* HELPER METHOD: snapshot_checksum - folds some bytes into a running checksum
+ * - FNV-1a, but taking 8 bytes at a time where it can; the writer and the reader must therefore hand it the
+ *   bytes in the same pieces, which they do by reading everything back with the same calls it was written
+ *
+ * parameters:
+ * - checksum: the checksum so far, or SNAPSHOT_CHECKSUM_START to begin
+ * - data: pointer to the bytes
+ * - bytes: how many bytes there are
+ *
+ * returns:
+ * - the new checksum
+*/
+static uint64_t snapshot_checksum(uint64_t checksum, const void *data, uint64_t bytes)
+{
+    const uint64_t prime = 0x100000001b3ULL;
+    const uint8_t *next = static_cast<const uint8_t*>(data);
+    for (; bytes >= sizeof(uint64_t); bytes -= sizeof(uint64_t), next += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, next, sizeof(word));
+        checksum = (checksum ^ word)*prime;
+    }
+    for (; bytes > 0; bytes--, next++) checksum = (checksum ^ *next)*prime;
+    return checksum;
+}